@@ -0,0 +1,128 @@
+// End-to-end throughput of GraphGenerationController over thread counts
+// from 1 to twice the hardware threads and a grid of batch sizes and
+// params. Prints CSV, one row per configuration.
+// Usage: controller_benchmark [max_threads_count]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "../graph_generation_controller.hpp"
+#include "../graph_generator.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+using GraphGenerationController = uni_course_cpp::GraphGenerationController;
+using GraphGenerator = uni_course_cpp::GraphGenerator;
+
+constexpr int kGraphsCounts[] = {16, 64};
+constexpr int kDepths[] = {4, 6};
+constexpr int kNewVerticesCounts[] = {3, 5};
+
+double get_process_cpu_seconds() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+// Resets the peak resident set size, so every configuration reports its
+// own peak. Linux only, the peak keeps growing elsewhere.
+void reset_peak_rss() {
+  auto clear_refs = std::ofstream("/proc/self/clear_refs");
+  clear_refs << "5";
+}
+
+double get_peak_rss_megabytes() {
+  auto status = std::ifstream("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0) {
+      return std::atof(line.c_str() + sizeof("VmHWM:")) / 1024;
+    }
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0;
+}
+
+double get_percentile(std::vector<double> values, double percentile) {
+  std::sort(values.begin(), values.end());
+  const auto index = static_cast<std::size_t>(percentile * (values.size() - 1));
+  return values[index];
+}
+
+void run_benchmark(int threads_count,
+                   int graphs_count,
+                   int depth,
+                   int new_vertices_count) {
+  auto controller = GraphGenerationController(
+      threads_count, graphs_count,
+      GraphGenerator::Params(depth, new_vertices_count));
+
+  // The callbacks are serialized by the controller
+  auto start_times = std::vector<Clock::time_point>(graphs_count);
+  auto latencies = std::vector<double>();
+  latencies.reserve(graphs_count);
+
+  reset_peak_rss();
+  const auto start_cpu_seconds = get_process_cpu_seconds();
+  const auto start_time = Clock::now();
+
+  controller.generate(
+      [&start_times](int index) { start_times[index] = Clock::now(); },
+      [&start_times, &latencies](int index, uni_course_cpp::Graph&&,
+                                 uni_course_cpp::GenerationStatus, bool) {
+        latencies.push_back(std::chrono::duration<double, std::milli>(
+                                Clock::now() - start_times[index])
+                                .count());
+      });
+
+  const double batch_seconds =
+      std::chrono::duration<double>(Clock::now() - start_time).count();
+  const double cpu_seconds = get_process_cpu_seconds() - start_cpu_seconds;
+  const int hardware_threads_count =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+  // Utilization of all hardware threads, the busy waiting of the controller
+  // and of idle workers counts as used
+  std::printf("%d,%d,%d,%d,%.3f,%.1f,%.3f,%.3f,%.3f,%.1f\n", threads_count,
+              graphs_count, depth, new_vertices_count, batch_seconds * 1000,
+              graphs_count / batch_seconds, get_percentile(latencies, 0.5),
+              get_percentile(latencies, 0.99),
+              cpu_seconds / (batch_seconds * hardware_threads_count),
+              get_peak_rss_megabytes());
+  std::fflush(stdout);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int hardware_threads_count =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  const int max_threads_count =
+      argc > 1 ? std::atoi(argv[1]) : 2 * hardware_threads_count;
+
+  std::printf(
+      "threads,graphs,depth,new_vertices,batch_ms,graphs_per_second,"
+      "p50_latency_ms,p99_latency_ms,cpu_utilization,peak_rss_mb\n");
+  for (int threads_count = 1; threads_count <= max_threads_count;
+       threads_count++) {
+    for (const int graphs_count : kGraphsCounts) {
+      for (const int depth : kDepths) {
+        for (const int new_vertices_count : kNewVerticesCounts) {
+          run_benchmark(threads_count, graphs_count, depth,
+                        new_vertices_count);
+        }
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,292 @@
+// Graph primitives and the scans used by printing over graph sizes from
+// 1e3 edges up to the size given on the command line (1e7 by default).
+// Reports time and heap allocations per operation. The JSON printer is
+// compared with the fragment by fragment printer it replaced.
+// Usage: graph_benchmark [max_edges_count]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../buffered_writer.hpp"
+#include "../graph.hpp"
+#include "../graph_json_printing.hpp"
+#include "../graph_printing.hpp"
+
+namespace {
+std::atomic<std::size_t> allocated_bytes = 0;
+std::atomic<std::size_t> allocations_count = 0;
+}  // namespace
+
+void* operator new(std::size_t size) {
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  allocations_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* const pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+// Not inlined, otherwise GCC pairs the free with the operator new of the
+// standard allocator and reports a mismatched deallocation
+[[gnu::noinline]] void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+[[gnu::noinline]] void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace {
+using Graph = uni_course_cpp::Graph;
+
+constexpr int kTreeBranchesCount = 4;
+constexpr long long kMinEdgesCount = 1000;
+constexpr long long kDefaultMaxEdgesCount = 10'000'000;
+
+// Keeps the compiler from dropping the measured work
+volatile std::size_t sink = 0;
+
+template <typename Operation>
+void run_benchmark(const std::string& name,
+                   long long edges_count,
+                   long long operations_count,
+                   const Operation& operation) {
+  const auto start_bytes = allocated_bytes.load();
+  const auto start_allocations = allocations_count.load();
+  const auto start_time = std::chrono::steady_clock::now();
+
+  operation();
+
+  const auto time = std::chrono::steady_clock::now() - start_time;
+  const auto bytes = allocated_bytes.load() - start_bytes;
+  const auto allocations = allocations_count.load() - start_allocations;
+
+  const double operations = std::max(operations_count, 1LL);
+  std::printf("%-32s %10lld %10lld %12.1f %12.1f %10.2f\n", name.c_str(),
+              edges_count, operations_count,
+              std::chrono::duration<double, std::nano>(time).count() /
+                  operations,
+              bytes / operations, allocations / operations);
+}
+
+// Tree in breadth-first order, the children of the i-th vertex of a depth
+// are the vertices from kTreeBranchesCount * i of the next depth
+Graph make_tree(long long vertices_count) {
+  auto graph = Graph();
+  graph.add_vertex();
+  for (long long i = 1; i < vertices_count; i++) {
+    const auto vertex_id = graph.add_vertex();
+    graph.add_edge((i - 1) / kTreeBranchesCount, vertex_id);
+  }
+  return graph;
+}
+
+// The printer before the compile time layouts, every fragment is a separate
+// write. Prints the same document as the Pretty style in the Id order.
+void write_legacy_vertex(Graph::VertexId vertex_id,
+                         const Graph& graph,
+                         uni_course_cpp::BufferedWriter& writer) {
+  writer.write("{\"id\":");
+  writer.write(vertex_id);
+  writer.write(",\"edge_ids\":[");
+  bool is_first_edge = true;
+  for (const auto edge_id : graph.get_connected_edge_ids(vertex_id)) {
+    if (!is_first_edge) {
+      writer.write(',');
+    }
+    writer.write(edge_id);
+    is_first_edge = false;
+  }
+  writer.write("],\"depth\":");
+  writer.write(graph.get_vertex_depth(vertex_id));
+  writer.write('}');
+}
+
+void write_legacy_edge(const Graph::Edge& edge,
+                       uni_course_cpp::BufferedWriter& writer) {
+  writer.write("{\"id\":");
+  writer.write(edge.id());
+  writer.write(",\"vertex_ids\":[");
+  writer.write(edge.from_vertex_id());
+  writer.write(',');
+  writer.write(edge.to_vertex_id());
+  writer.write("],\"color\":\"");
+  writer.write(uni_course_cpp::printing::get_edge_color_name(edge.color()));
+  writer.write("\"}");
+}
+
+std::string print_legacy_graph(const Graph& graph) {
+  std::string graph_json;
+  {
+    auto writer = uni_course_cpp::StringWriter(graph_json);
+    writer.write("{\n\t\"depth\":");
+    writer.write(graph.get_depth());
+    writer.write(",\n\t\"vertices\": [\n");
+    const auto& vertices = graph.get_vertices();
+    for (Graph::VertexId vertex_id = 0;
+         static_cast<std::size_t>(vertex_id) < vertices.size(); vertex_id++) {
+      writer.write(vertex_id == 0 ? "\t\t" : ",\n\t\t");
+      write_legacy_vertex(vertex_id, graph, writer);
+    }
+    writer.write("\n\t],\n\t\"edges\":[\n");
+    const auto& edges = graph.get_edges();
+    for (Graph::EdgeId edge_id = 0;
+         static_cast<std::size_t>(edge_id) < edges.size(); edge_id++) {
+      writer.write(edge_id == 0 ? "\t\t" : ",\n\t\t");
+      write_legacy_edge(edges.at(edge_id), writer);
+    }
+    writer.write("\n\t]\n}\n");
+  }
+  return graph_json;
+}
+
+void run_benchmarks(long long edges_count) {
+  const auto size = std::to_string(edges_count);
+
+  run_benchmark("add_vertex", edges_count, edges_count, [edges_count]() {
+    auto graph = Graph();
+    for (long long i = 0; i < edges_count; i++) {
+      graph.add_vertex();
+    }
+    sink = sink + graph.get_vertices().size();
+  });
+
+  // A grey edge needs a fresh vertex, adding all of them first would make
+  // every edge scan the vertices of the default depth
+  run_benchmark("add_vertex + add_edge grey", edges_count, edges_count,
+                [edges_count]() {
+                  const auto graph = make_tree(edges_count + 1);
+                  sink = sink + graph.get_edges().size();
+                });
+
+  auto graph = make_tree(edges_count + 1);
+  const auto depth = graph.get_depth();
+  const auto& previous_ids = graph.get_depth_vertex_ids(depth - 2);
+  const auto& parent_ids = graph.get_depth_vertex_ids(depth - 1);
+  const auto& last_ids = graph.get_depth_vertex_ids(depth);
+
+  const long long green_count = edges_count / 10;
+  run_benchmark("add_edge green", edges_count, green_count,
+                [&graph, green_count]() {
+                  for (long long i = 0; i < green_count; i++) {
+                    graph.add_edge(i, i);
+                  }
+                });
+
+  // Every parent is connected to a vertex of the next depth which is a
+  // child of its neighbour
+  const long long yellow_count = parent_ids.size() > 1 ? parent_ids.size() : 0;
+  run_benchmark("add_edge yellow", edges_count, yellow_count,
+                [&graph, &parent_ids, &last_ids, yellow_count]() {
+                  for (long long i = 0; i < yellow_count; i++) {
+                    const auto child_index =
+                        (kTreeBranchesCount * (i + 1)) % last_ids.size();
+                    graph.add_edge(parent_ids[i], last_ids[child_index]);
+                  }
+                });
+
+  const long long red_count = previous_ids.size();
+  run_benchmark("add_edge red", edges_count, red_count,
+                [&graph, &previous_ids, &last_ids, red_count]() {
+                  for (long long i = 0; i < red_count; i++) {
+                    graph.add_edge(previous_ids[i],
+                                   last_ids[(i * 17) % last_ids.size()]);
+                  }
+                });
+
+  const long long queries_count = std::min(edges_count, 1'000'000LL);
+  run_benchmark("is_vertices_connected", edges_count, queries_count,
+                [&graph, edges_count, queries_count]() {
+                  std::size_t connected_count = 0;
+                  for (long long i = 0; i < queries_count; i++) {
+                    const auto vertex_id = (i * 7919) % edges_count + 1;
+                    connected_count += graph.is_vertices_connected(
+                        (vertex_id - 1) / kTreeBranchesCount + i % 2,
+                        vertex_id);
+                  }
+                  sink = sink + connected_count;
+                });
+
+  run_benchmark("get_depth_vertex_ids", edges_count, queries_count,
+                [&graph, depth, queries_count]() {
+                  std::size_t vertices_count = 0;
+                  for (long long i = 0; i < queries_count; i++) {
+                    vertices_count +=
+                        graph.get_depth_vertex_ids(i % (depth + 1)).size();
+                  }
+                  sink = sink + vertices_count;
+                });
+
+  const long long total_edges_count = graph.get_edges().size();
+  run_benchmark("scan vertices + adjacency", edges_count,
+                graph.get_vertices().size(), [&graph]() {
+                  std::size_t edge_ids_count = 0;
+                  for (const auto& [vertex_id, vertex] : graph.get_vertices()) {
+                    edge_ids_count +=
+                        graph.get_connected_edge_ids(vertex.id()).size() +
+                        graph.get_vertex_depth(vertex_id);
+                  }
+                  sink = sink + edge_ids_count;
+                });
+
+  run_benchmark("scan edges", edges_count, total_edges_count, [&graph]() {
+    std::size_t vertex_ids_sum = 0;
+    for (const auto& [edge_id, edge] : graph.get_edges()) {
+      vertex_ids_sum += edge.from_vertex_id() + edge.to_vertex_id() +
+                        static_cast<int>(edge.color());
+    }
+    sink = sink + vertex_ids_sum;
+  });
+
+  run_benchmark("printing::print_graph", edges_count, 1, [&graph]() {
+    sink = sink + uni_course_cpp::printing::print_graph(graph).size();
+  });
+
+  namespace json = uni_course_cpp::printing::json;
+  run_benchmark("json::print_graph old per edge", edges_count,
+                total_edges_count, [&graph]() {
+                  sink = sink + print_legacy_graph(graph).size();
+                });
+
+  run_benchmark("json::print_graph per edge", edges_count, total_edges_count,
+                [&graph]() {
+                  sink = sink + json::print_graph(graph, json::ElementOrder::Id)
+                                    .size();
+                });
+
+  run_benchmark("json::print_graph compact", edges_count, total_edges_count,
+                [&graph]() {
+                  sink = sink + json::print_graph(graph, json::ElementOrder::Id,
+                                                  json::Style::Compact)
+                                    .size();
+                });
+
+  // Measured above, checked here so a faster but different document shows up
+  if (print_legacy_graph(graph) !=
+      json::print_graph(graph, json::ElementOrder::Id)) {
+    std::printf("json::print_graph differs from the old printer\n");
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const long long max_edges_count =
+      argc > 1 ? std::atoll(argv[1]) : kDefaultMaxEdgesCount;
+
+  std::printf("%-32s %10s %10s %12s %12s %10s\n", "benchmark", "edges",
+              "operations", "ns/op", "bytes/op", "allocs/op");
+  for (long long edges_count = kMinEdgesCount; edges_count <= max_edges_count;
+       edges_count *= 10) {
+    run_benchmarks(edges_count);
+    std::fflush(stdout);
+  }
+
+  return 0;
+}
@@ -0,0 +1,20 @@
+#include "variant_adapter.hpp"
+
+#include "graph_generator.hpp"
+#include "printing_json.hpp"
+
+namespace variant_benchmark {
+namespace {
+uni_course_cpp::Graph graph;
+}  // namespace
+
+void generate_graph(int depth, int new_vertices_count, std::uint32_t) {
+  graph = uni_course_cpp::GraphGenerator(
+              uni_course_cpp::GraphGenerator::Params(depth, new_vertices_count))
+              .generate();
+}
+
+std::string print_graph_json() {
+  return uni_course_cpp::json::print_graph(graph);
+}
+}  // namespace variant_benchmark
@@ -0,0 +1,22 @@
+#include "variant_adapter.hpp"
+
+// The variant's graph.hpp relies on its includer for std::runtime_error
+#include <stdexcept>
+
+#include "graph_generator.hpp"
+#include "printing.hpp"
+
+namespace variant_benchmark {
+namespace {
+Graph graph;
+}  // namespace
+
+void generate_graph(int depth, int new_vertices_count, std::uint32_t) {
+  graph = GraphGenerator(GraphGenerator::Params(depth, new_vertices_count))
+              .generate();
+}
+
+std::string print_graph_json() {
+  return printing::json::print_graph(graph);
+}
+}  // namespace variant_benchmark
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace variant_benchmark {
+// Implemented by an adapter, which is built into its own executable
+// together with the sources of one variant. Variants sharing the same API
+// share generic_adapter.cpp, the others have an adapter named after them.
+// The graph is kept by the adapter until the next generation. Variants
+// which can't seed their generator ignore the seed.
+void generate_graph(int depth, int new_vertices_count, std::uint32_t seed);
+std::string print_graph_json();
+}  // namespace variant_benchmark
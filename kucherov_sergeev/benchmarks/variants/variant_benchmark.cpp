@@ -0,0 +1,87 @@
+// Generates and exports graphs of the same params with one variant and
+// prints a row of the comparison table. make variants_benchmark runs it
+// for every variant with the same params and seed, run i uses the seed + i.
+// Usage: <variant>_benchmark <name> <depth> <new_vertices_count> <runs> <seed>
+//        <variant>_benchmark --header
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "variant_adapter.hpp"
+
+namespace {
+double get_median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  const auto middle = values.size() / 2;
+  return values.size() % 2 == 1 ? values[middle]
+                                : (values[middle - 1] + values[middle]) / 2;
+}
+
+template <typename Operation>
+double measure_milliseconds(const Operation& operation) {
+  const auto start_time = std::chrono::steady_clock::now();
+  operation();
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start_time)
+      .count();
+}
+
+double get_peak_rss_megabytes() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  // Kilobytes on Linux
+  return usage.ru_maxrss / 1024.0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc == 2 && std::string(argv[1]) == "--header") {
+    std::printf("%-20s %6s %8s %5s %10s %12s %12s %14s %10s\n", "variant",
+                "depth", "vertices", "runs", "seed", "generate ms", "json ms",
+                "json bytes", "rss MB");
+    return 0;
+  }
+  if (argc != 6) {
+    std::fprintf(
+        stderr,
+        "Usage: %s <name> <depth> <new_vertices_count> <runs> <seed>\n",
+        argv[0]);
+    return 1;
+  }
+
+  const std::string name = argv[1];
+  const int depth = std::atoi(argv[2]);
+  const int new_vertices_count = std::atoi(argv[3]);
+  const int runs_count = std::max(std::atoi(argv[4]), 1);
+  const auto seed =
+      static_cast<std::uint32_t>(std::strtoul(argv[5], nullptr, 10));
+
+  auto generation_times = std::vector<double>();
+  auto json_times = std::vector<double>();
+  double json_size = 0;
+  for (int i = 0; i < runs_count; i++) {
+    generation_times.push_back(
+        measure_milliseconds([depth, new_vertices_count, seed, i]() {
+          variant_benchmark::generate_graph(depth, new_vertices_count,
+                                            seed + i);
+        }));
+    std::string json;
+    json_times.push_back(measure_milliseconds(
+        [&json]() { json = variant_benchmark::print_graph_json(); }));
+    json_size += json.size();
+  }
+
+  std::printf("%-20s %6d %8d %5d %10lu %12.3f %12.3f %14.0f %10.1f\n",
+              name.c_str(), depth, new_vertices_count, runs_count,
+              static_cast<unsigned long>(seed),
+              get_median(generation_times), get_median(json_times),
+              json_size / runs_count, get_peak_rss_megabytes());
+  return 0;
+}
@@ -0,0 +1,59 @@
+#include <cerrno>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "buffered_writer.hpp"
+
+namespace uni_course_cpp {
+FileWriter::FileWriter(const std::string& file_path, std::size_t buffer_size)
+    : BufferedWriter(buffer_size),
+      file_descriptor_(
+          ::open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) {
+  if (file_descriptor_ == -1) {
+    throw std::runtime_error("Failed to open file " + file_path);
+  }
+}
+
+FileWriter::~FileWriter() {
+  try {
+    close();
+  } catch (const std::exception&) {
+  }
+}
+
+void FileWriter::close() {
+  if (file_descriptor_ == -1) {
+    return;
+  }
+
+  const int file_descriptor = file_descriptor_;
+  try {
+    flush();
+  } catch (const std::exception&) {
+    file_descriptor_ = -1;
+    ::close(file_descriptor);
+    throw;
+  }
+
+  file_descriptor_ = -1;
+  if (::close(file_descriptor) != 0) {
+    throw std::runtime_error("Failed to close file");
+  }
+}
+
+void FileWriter::write_block(const char* data, std::size_t size) {
+  while (size > 0) {
+    const auto written_size = ::write(file_descriptor_, data, size);
+    if (written_size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("Failed to write file");
+    }
+    data += written_size;
+    size -= written_size;
+  }
+}
+}  // namespace uni_course_cpp
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace uni_course_cpp {
+// Collects the output in a fixed buffer and hands it over in large blocks,
+// so the whole document is never kept in memory.
+class BufferedWriter {
+ public:
+  static constexpr std::size_t kDefaultBufferSize = 1 << 20;
+  // Smaller buffers are enlarged, so any number fits after a flush
+  static constexpr std::size_t kMinBufferSize = 20;
+
+  explicit BufferedWriter(std::size_t buffer_size = kDefaultBufferSize)
+      : buffer_(std::max(buffer_size, kMinBufferSize)) {}
+  virtual ~BufferedWriter() = default;
+
+  BufferedWriter(const BufferedWriter& other) = delete;
+  void operator=(const BufferedWriter& other) = delete;
+
+  void write(char character) {
+    if (size_ == buffer_.size()) {
+      flush();
+    }
+    buffer_[size_++] = character;
+  }
+
+  void write(std::string_view string) {
+    if (string.size() > buffer_.size() - size_) {
+      flush();
+      if (string.size() > buffer_.size()) {
+        write_block(string.data(), string.size());
+        return;
+      }
+    }
+    string.copy(buffer_.data() + size_, string.size());
+    size_ += string.size();
+  }
+
+  void write(long long number) {
+    if (buffer_.size() - size_ < kMaxNumberLength) {
+      flush();
+    }
+    const auto result = std::to_chars(buffer_.data() + size_,
+                                      buffer_.data() + buffer_.size(), number);
+    size_ = result.ptr - buffer_.data();
+  }
+
+  void write(int number) { write(static_cast<long long>(number)); }
+
+  // Direct access to at least size free bytes of the buffer, for writers
+  // which know an upper bound of their output. The end of what was actually
+  // written is passed to commit().
+  char* reserve(std::size_t size) {
+    if (buffer_.size() - size_ < size) {
+      flush();
+      if (buffer_.size() < size) {
+        buffer_.resize(size);
+      }
+    }
+    return buffer_.data() + size_;
+  }
+
+  void commit(const char* end) { size_ = end - buffer_.data(); }
+
+  void flush() {
+    if (size_ != 0) {
+      write_block(buffer_.data(), size_);
+      size_ = 0;
+    }
+  }
+
+ protected:
+  virtual void write_block(const char* data, std::size_t size) = 0;
+
+ private:
+  static constexpr std::size_t kMaxNumberLength = 20;
+  static_assert(kMaxNumberLength <= kMinBufferSize);
+
+  std::vector<char> buffer_;
+  std::size_t size_ = 0;
+};
+
+// Writes straight to the file descriptor, the file is truncated on opening
+class FileWriter : public BufferedWriter {
+ public:
+  explicit FileWriter(const std::string& file_path,
+                      std::size_t buffer_size = kDefaultBufferSize);
+  ~FileWriter() override;
+
+  // Flushes and closes the file, throws if the data can't be written.
+  // The destructor does the same, but ignores errors.
+  void close();
+
+ protected:
+  void write_block(const char* data, std::size_t size) override;
+
+ private:
+  int file_descriptor_ = -1;
+};
+
+class StringWriter : public BufferedWriter {
+ public:
+  explicit StringWriter(std::string& string,
+                        std::size_t buffer_size = kDefaultBufferSize)
+      : BufferedWriter(buffer_size), string_(string) {}
+  ~StringWriter() override { flush(); }
+
+ protected:
+  void write_block(const char* data, std::size_t size) override {
+    string_.append(data, size);
+  }
+
+ private:
+  std::string& string_;
+};
+}  // namespace uni_course_cpp
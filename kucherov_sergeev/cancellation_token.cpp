@@ -0,0 +1,60 @@
+#include <algorithm>
+
+#include "cancellation_token.hpp"
+
+namespace uni_course_cpp {
+CancellationToken::CancellationToken()
+    : CancellationToken(std::make_shared<std::atomic<bool>>(false),
+                        std::nullopt) {}
+
+CancellationToken::CancellationToken(
+    std::shared_ptr<std::atomic<bool>> is_cancelled,
+    std::optional<Clock::time_point> deadline)
+    : is_cancelled_(std::move(is_cancelled)),
+      deadline_(deadline),
+      status_(std::make_shared<std::atomic<GenerationStatus>>(
+          GenerationStatus::Completed)) {}
+
+CancellationToken CancellationToken::make_child() const {
+  return CancellationToken(is_cancelled_, deadline_);
+}
+
+CancellationToken CancellationToken::with_deadline(
+    Clock::time_point deadline) const {
+  const auto new_deadline =
+      deadline_.has_value() ? std::min(deadline_.value(), deadline) : deadline;
+
+  return CancellationToken(is_cancelled_, new_deadline);
+}
+
+CancellationToken CancellationToken::with_timeout(
+    Clock::duration timeout) const {
+  return with_deadline(Clock::now() + timeout);
+}
+
+void CancellationToken::cancel() const {
+  *is_cancelled_ = true;
+}
+
+bool CancellationToken::is_stopped() const {
+  if (*status_ != GenerationStatus::Completed) {
+    return true;
+  }
+
+  if (*is_cancelled_) {
+    *status_ = GenerationStatus::Cancelled;
+    return true;
+  }
+
+  if (deadline_.has_value() && Clock::now() >= deadline_.value()) {
+    *status_ = GenerationStatus::DeadlineExceeded;
+    return true;
+  }
+
+  return false;
+}
+
+GenerationStatus CancellationToken::status() const {
+  return *status_;
+}
+}  // namespace uni_course_cpp
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+
+namespace uni_course_cpp {
+enum class GenerationStatus { Completed, DeadlineExceeded, Cancelled };
+
+class CancellationToken {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  CancellationToken();
+
+  // Derived tokens share the cancellation flag, but have their own deadline
+  // and status, so a per-graph deadline doesn't stop the whole batch.
+  CancellationToken make_child() const;
+  CancellationToken with_deadline(Clock::time_point deadline) const;
+  CancellationToken with_timeout(Clock::duration timeout) const;
+
+  void cancel() const;
+
+  // Latches the reason of the stop, so status() reports it even if the
+  // deadline is checked again later.
+  bool is_stopped() const;
+
+  GenerationStatus status() const;
+
+ private:
+  CancellationToken(std::shared_ptr<std::atomic<bool>> is_cancelled,
+                    std::optional<Clock::time_point> deadline);
+
+  std::shared_ptr<std::atomic<bool>> is_cancelled_;
+  std::optional<Clock::time_point> deadline_;
+  std::shared_ptr<std::atomic<GenerationStatus>> status_;
+};
+}  // namespace uni_course_cpp
@@ -1,13 +1,59 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <optional>
 #include <string>
 
+#include "log_level.hpp"
+#include "timestamp.hpp"
+
 namespace uni_course_cpp {
 namespace config {
 
 inline constexpr const char* kTempDirectoryPath = "./temp/";
 inline const std::string kLogFilename = "log.txt";
 inline const std::string kLogFilePath = kTempDirectoryPath + kLogFilename;
+// Runtime level, levels below kMinLogLevel are compiled out regardless
+inline constexpr LogLevel kLogLevel = LogLevel::Info;
+inline constexpr std::size_t kLogQueueCapacity = 4096;
+inline constexpr std::chrono::milliseconds kLogFlushInterval =
+    std::chrono::milliseconds(10);
+inline constexpr auto kLogTimestampClock = TimestampClock::System;
+inline constexpr auto kLogTimestampResolution =
+    TimestampResolution::Milliseconds;
+// Log generation events as binary records to kEventLogFilePath instead of
+// text lines, tools/decode_events turns them into text, JSON or CSV
+inline constexpr bool kStructuredLogging = false;
+inline const std::string kEventLogFilePath =
+    kTempDirectoryPath + std::string("events.bin");
+// Record a timeline of the workers, generation phases and file writes to
+// kTraceFilePath, open it in chrome://tracing or Perfetto
+inline constexpr bool kTracingEnabled = false;
+inline const std::string kTraceFilePath =
+    kTempDirectoryPath + std::string("trace.json");
+// Count cycles, instructions, LLC and branch misses of the generation phases
+// and serializers with perf_event_open, unsupported counters print as n/a
+inline constexpr bool kPerfCountersEnabled = false;
+// Add the heap bytes of every graph by structure to its log line
+inline constexpr bool kLogGraphMemoryUsage = false;
+// Also write every graph to the binary format read by binary::MappedGraph
+inline constexpr bool kWriteBinaryGraphs = false;
+// Also write every graph to the compact format read by compact::decode_graph
+inline constexpr bool kWriteCompactGraphs = false;
+inline constexpr int kFileWritingThreadsCount = 2;
+// Don't write graphs isomorphic to one already generated in the batch
+inline constexpr bool kDeduplicateGraphs = false;
+// Emit JSON elements in id order, so equal graphs give equal files
+inline constexpr bool kDeterministicJsonOutput = true;
+// Write JSON without whitespace
+inline constexpr bool kCompactJsonOutput = false;
+// Larger graphs are serialized to JSON by several threads
+inline constexpr int kParallelJsonMinEdgesCount = 1 << 18;
+// Cut every graph off after the timeout and write what is generated by
+// then, no deadline if unset
+inline constexpr std::optional<std::chrono::milliseconds>
+    kGraphGenerationTimeout = std::nullopt;
 
 }  // namespace config
 }  // namespace uni_course_cpp
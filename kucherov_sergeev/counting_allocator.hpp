@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace uni_course_cpp {
+// Bytes held by the containers sharing the counter. Hash tables allocate
+// their bucket arrays as arrays of pointers, which is how they are told
+// apart from the nodes.
+struct AllocationCounter {
+  std::size_t allocated_bytes = 0;
+  std::size_t hash_bucket_bytes = 0;
+};
+
+// Allocator reporting to an external counter, which must outlive the
+// containers. A default constructed one counts nothing, as do copies of the
+// containers unless they are given a counter explicitly. Copy assignment
+// keeps the counter of the destination, moves and swaps take the counter
+// along. The counter isn't synchronized, the containers are expected to be
+// mutated under one lock.
+template <typename T>
+class CountingAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  CountingAllocator() = default;
+  explicit CountingAllocator(AllocationCounter* counter) : counter_(counter) {}
+
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>& other)
+      : counter_(other.get_counter()) {}
+
+  T* allocate(std::size_t count) {
+    count_bytes(count, true);
+    return static_cast<T*>(::operator new(count * sizeof(T)));
+  }
+
+  void deallocate(T* pointer, std::size_t count) {
+    count_bytes(count, false);
+    ::operator delete(pointer);
+  }
+
+  CountingAllocator select_on_container_copy_construction() const {
+    return CountingAllocator();
+  }
+
+  AllocationCounter* get_counter() const { return counter_; }
+
+ private:
+  void count_bytes(std::size_t count, bool is_allocated) {
+    if (counter_ == nullptr) {
+      return;
+    }
+    const auto bytes = count * sizeof(T);
+    auto& counter_bytes = std::is_pointer_v<T> ? counter_->hash_bucket_bytes
+                                               : counter_->allocated_bytes;
+    if (is_allocated) {
+      counter_bytes += bytes;
+    } else {
+      counter_bytes -= bytes;
+    }
+  }
+
+  AllocationCounter* counter_ = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const CountingAllocator<T>& first,
+                const CountingAllocator<U>& second) {
+  return first.get_counter() == second.get_counter();
+}
+
+template <typename T, typename U>
+bool operator!=(const CountingAllocator<T>& first,
+                const CountingAllocator<U>& second) {
+  return !(first == second);
+}
+}  // namespace uni_course_cpp
@@ -0,0 +1,179 @@
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+#include "event_log.hpp"
+
+namespace uni_course_cpp {
+namespace event_log {
+namespace {
+static_assert(sizeof(FileHeader) == 16);
+static_assert(sizeof(RecordHeader) == 16);
+static_assert(sizeof(GenerationFinishedRecord) == 48);
+
+template <typename T>
+char* write_value(char* position, const T& value) {
+  std::memcpy(position, &value, sizeof(T));
+  return position + sizeof(T);
+}
+
+template <typename T>
+T read_value(std::string_view& data) {
+  if (data.size() < sizeof(T)) {
+    throw std::runtime_error("Event log is truncated");
+  }
+  T value;
+  std::memcpy(&value, data.data(), sizeof(T));
+  data.remove_prefix(sizeof(T));
+  return value;
+}
+
+bool is_valid_status(std::uint32_t status) {
+  return status <= static_cast<std::uint32_t>(GenerationStatus::Cancelled);
+}
+
+Event read_generation_finished(std::string_view payload) {
+  const auto record = read_value<GenerationFinishedRecord>(payload);
+  if (!is_valid_status(record.status) || record.depth_buckets_count < 0 ||
+      payload.size() !=
+          record.depth_buckets_count * sizeof(std::int32_t)) {
+    throw std::runtime_error("Invalid generation finished record");
+  }
+
+  auto event = Event();
+  event.type = EventType::GenerationFinished;
+  event.graph_index = record.graph_index;
+  event.status = static_cast<GenerationStatus>(record.status);
+  event.duration = TimestampFormatter::Duration(record.duration);
+  event.summary.depth = record.depth;
+  event.summary.vertices_count = record.vertices_count;
+  event.summary.edges_count = record.edges_count;
+  for (int color = 0; color < Graph::Edge::kColorsCount; color++) {
+    event.summary.color_edges_counts[color] = record.color_edges_counts[color];
+  }
+  event.summary.depth_vertices_counts.reserve(record.depth_buckets_count);
+  while (!payload.empty()) {
+    event.summary.depth_vertices_counts.push_back(
+        read_value<std::int32_t>(payload));
+  }
+  return event;
+}
+}  // namespace
+
+EventLogWriter::EventLogWriter(const std::string& file_path,
+                               TimestampClock clock)
+    : clock_(clock), file_writer_(file_path, kBufferSize) {
+  auto header = FileHeader();
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.clock = static_cast<std::uint32_t>(clock);
+  file_writer_.write(std::string_view(reinterpret_cast<const char*>(&header),
+                                      sizeof(header)));
+}
+
+void EventLogWriter::log_generation_started(int graph_index) {
+  const auto header =
+      RecordHeader{sizeof(GenerationStartedRecord),
+                   EventType::GenerationStarted,
+                   TimestampFormatter::now(clock_).count()};
+  const auto record = GenerationStartedRecord{graph_index};
+
+  const std::lock_guard lock(mutex_);
+  auto* position = file_writer_.reserve(sizeof(header) + sizeof(record));
+  position = write_value(position, header);
+  file_writer_.commit(write_value(position, record));
+}
+
+void EventLogWriter::log_generation_finished(
+    int graph_index,
+    GenerationStatus status,
+    TimestampFormatter::Duration duration,
+    const Graph& graph) {
+  const auto time = TimestampFormatter::now(clock_);
+
+  auto record = GenerationFinishedRecord();
+  record.graph_index = graph_index;
+  record.status = static_cast<std::uint32_t>(status);
+  record.duration = duration.count();
+  record.depth = graph.get_depth();
+  record.vertices_count = graph.get_vertices().size();
+  record.edges_count = graph.get_edges().size();
+  for (int color = 0; color < Graph::Edge::kColorsCount; color++) {
+    record.color_edges_counts[color] =
+        graph.get_color_edge_ids(static_cast<Graph::Edge::Color>(color))
+            .size();
+  }
+  record.depth_buckets_count = record.depth + 1;
+
+  const std::size_t payload_size =
+      sizeof(record) + record.depth_buckets_count * sizeof(std::int32_t);
+  const auto header = RecordHeader{static_cast<std::uint32_t>(payload_size),
+                                   EventType::GenerationFinished, time.count()};
+
+  const std::lock_guard lock(mutex_);
+  auto* position = file_writer_.reserve(sizeof(header) + payload_size);
+  position = write_value(position, header);
+  position = write_value(position, record);
+  for (Graph::Depth depth = 0; depth <= record.depth; depth++) {
+    position = write_value(position, static_cast<std::int32_t>(
+                                         graph.get_depth_vertex_ids(depth)
+                                             .size()));
+  }
+  file_writer_.commit(position);
+}
+
+void EventLogWriter::flush() {
+  const std::lock_guard lock(mutex_);
+  file_writer_.flush();
+}
+
+EventLogContents read_event_log(const std::string& file_path) {
+  auto file = std::ifstream(file_path, std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open file " + file_path);
+  }
+  const auto file_data = std::string(std::istreambuf_iterator<char>(file),
+                                     std::istreambuf_iterator<char>());
+  auto data = std::string_view(file_data);
+
+  const auto header = read_value<FileHeader>(data);
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion ||
+      header.clock > static_cast<std::uint32_t>(TimestampClock::Steady)) {
+    throw std::runtime_error("Invalid event log header");
+  }
+
+  auto contents = EventLogContents();
+  contents.clock = static_cast<TimestampClock>(header.clock);
+  while (!data.empty()) {
+    const auto record_header = read_value<RecordHeader>(data);
+    if (record_header.size > data.size()) {
+      throw std::runtime_error("Event log is truncated");
+    }
+    const auto payload = data.substr(0, record_header.size);
+    data.remove_prefix(record_header.size);
+
+    auto event = Event();
+    switch (record_header.type) {
+      case EventType::GenerationStarted: {
+        auto started_payload = payload;
+        const auto record = read_value<GenerationStartedRecord>(
+            started_payload);
+        event.graph_index = record.graph_index;
+        break;
+      }
+      case EventType::GenerationFinished:
+        event = read_generation_finished(payload);
+        break;
+      default:
+        throw std::runtime_error("Unknown event type");
+    }
+    event.time = TimestampFormatter::Duration(record_header.time);
+    contents.events.push_back(std::move(event));
+  }
+  return contents;
+}
+}  // namespace event_log
+}  // namespace uni_course_cpp
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "buffered_writer.hpp"
+#include "cancellation_token.hpp"
+#include "graph.hpp"
+#include "graph_summary.hpp"
+#include "timestamp.hpp"
+
+namespace uni_course_cpp {
+namespace event_log {
+// Generation events as binary records, formatted only when the log is
+// decoded. File layout:
+//   FileHeader
+//   Records: RecordHeader followed by RecordHeader::size bytes of payload
+// The payload of GenerationFinished is GenerationFinishedRecord followed by
+// int32[depth_buckets_count] vertices counts of every depth.
+inline constexpr char kMagic[4] = {'U', 'C', 'E', 'V'};
+inline constexpr std::uint32_t kVersion = 1;
+
+enum class EventType : std::uint32_t { GenerationStarted, GenerationFinished };
+
+struct FileHeader {
+  char magic[4];
+  std::uint32_t version;
+  // TimestampClock of the record times
+  std::uint32_t clock;
+  std::uint32_t reserved;
+};
+
+struct RecordHeader {
+  std::uint32_t size;
+  EventType type;
+  // TimestampFormatter::Duration since the clock epoch
+  std::int64_t time;
+};
+
+struct GenerationStartedRecord {
+  std::int32_t graph_index;
+};
+
+struct GenerationFinishedRecord {
+  std::int32_t graph_index;
+  // GenerationStatus
+  std::uint32_t status;
+  std::int64_t duration;
+  std::int32_t depth;
+  std::int32_t vertices_count;
+  std::int32_t edges_count;
+  std::int32_t color_edges_counts[Graph::Edge::kColorsCount];
+  std::int32_t depth_buckets_count;
+};
+
+struct Event {
+  EventType type = EventType::GenerationStarted;
+  TimestampFormatter::Duration time = TimestampFormatter::Duration::zero();
+  int graph_index = 0;
+  // The fields below are set for GenerationFinished only
+  GenerationStatus status = GenerationStatus::Completed;
+  TimestampFormatter::Duration duration = TimestampFormatter::Duration::zero();
+  GraphSummary summary;
+};
+
+struct EventLogContents {
+  TimestampClock clock = TimestampClock::System;
+  std::vector<Event> events;
+};
+
+// Thread-safe. A record costs a copy of a few dozen bytes into the buffer,
+// which is written to the file when it fills up and on destruction.
+class EventLogWriter {
+ public:
+  EventLogWriter(const std::string& file_path, TimestampClock clock);
+
+  EventLogWriter(const EventLogWriter& other) = delete;
+  void operator=(const EventLogWriter& other) = delete;
+
+  TimestampClock get_clock() const { return clock_; }
+
+  void log_generation_started(int graph_index);
+  void log_generation_finished(int graph_index,
+                               GenerationStatus status,
+                               TimestampFormatter::Duration duration,
+                               const Graph& graph);
+
+  // Writes the buffered records to the file
+  void flush();
+
+ private:
+  static constexpr std::size_t kBufferSize = 64 << 10;
+
+  const TimestampClock clock_;
+  std::mutex mutex_;
+  FileWriter file_writer_;
+};
+
+EventLogContents read_event_log(const std::string& file_path);
+}  // namespace event_log
+}  // namespace uni_course_cpp
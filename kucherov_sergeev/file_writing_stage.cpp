@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "file_writing_stage.hpp"
+#include "tracing.hpp"
+
+namespace uni_course_cpp {
+namespace {
+class FileDescriptor {
+ public:
+  FileDescriptor(const std::string& file_path, int flags)
+      : file_descriptor_(::open(file_path.c_str(), flags, 0644)) {
+    if (file_descriptor_ == -1) {
+      throw std::runtime_error("Failed to open file " + file_path);
+    }
+  }
+  ~FileDescriptor() {
+    if (file_descriptor_ != -1) {
+      ::close(file_descriptor_);
+    }
+  }
+
+  FileDescriptor(const FileDescriptor& other) = delete;
+  void operator=(const FileDescriptor& other) = delete;
+
+  int get() const { return file_descriptor_; }
+
+  void close() {
+    const int result = ::close(std::exchange(file_descriptor_, -1));
+    if (result != 0) {
+      throw std::runtime_error("Failed to close file");
+    }
+  }
+
+ private:
+  int file_descriptor_;
+};
+
+void sync_file(const FileDescriptor& file, const std::string& file_path) {
+  if (::fsync(file.get()) != 0) {
+    throw std::runtime_error("Failed to sync file " + file_path);
+  }
+}
+
+// For files closed by whoever wrote them, fsync flushes the data written
+// through any descriptor of the file
+void sync_file(const std::string& file_path) {
+  auto file = FileDescriptor(file_path, O_WRONLY);
+  sync_file(file, file_path);
+  file.close();
+}
+}  // namespace
+
+FileWritingStage::FileWritingStage(int threads_count,
+                                   std::size_t max_queued_bytes,
+                                   FsyncPolicy fsync_policy)
+    : max_queued_bytes_(max_queued_bytes), fsync_policy_(fsync_policy) {
+  threads_count = std::max(threads_count, 1);
+  threads_.reserve(threads_count);
+  for (int i = 0; i < threads_count; i++) {
+    threads_.emplace_back([this]() { run_writer(); });
+  }
+}
+
+FileWritingStage::~FileWritingStage() {
+  {
+    const std::lock_guard lock(mutex_);
+    is_stopping_ = true;
+  }
+  queue_changed_.notify_all();
+
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void FileWritingStage::enqueue(std::string file_path, std::string data) {
+  push({std::move(file_path), std::move(data), nullptr, nullptr});
+}
+
+void FileWritingStage::enqueue(std::string file_path,
+                               SerializeCallback serialize) {
+  push({std::move(file_path), {}, std::move(serialize), nullptr});
+}
+
+void FileWritingStage::enqueue(std::string file_path,
+                               WriteFileCallback write_file) {
+  push({std::move(file_path), {}, nullptr, std::move(write_file)});
+}
+
+void FileWritingStage::push(File&& file) {
+  const tracing::Span span("Enqueue File", "output");
+  auto lock = std::unique_lock(mutex_);
+  // A single file larger than the limit still passes through an empty queue
+  queue_changed_.wait(lock, [this, &file]() {
+    return queue_.empty() ||
+           queued_bytes_ + file.data.size() <= max_queued_bytes_;
+  });
+
+  queued_bytes_ += file.data.size();
+  queue_.push_back(std::move(file));
+  statistics_.max_queue_depth =
+      std::max(statistics_.max_queue_depth, queue_.size());
+
+  lock.unlock();
+  queue_changed_.notify_all();
+}
+
+void FileWritingStage::finish() {
+  auto lock = std::unique_lock(mutex_);
+  queue_changed_.wait(lock, [this]() {
+    return queue_.empty() && writing_files_count_ == 0;
+  });
+
+  auto file_paths = std::move(unsynced_file_paths_);
+  unsynced_file_paths_.clear();
+  auto error = std::exchange(error_, nullptr);
+  lock.unlock();
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  for (const auto& file_path : file_paths) {
+    sync_file(file_path);
+  }
+}
+
+FileWritingStage::Statistics FileWritingStage::get_statistics() const {
+  const std::lock_guard lock(mutex_);
+
+  auto statistics = statistics_;
+  statistics.queue_depth = queue_.size();
+  statistics.queued_bytes = queued_bytes_;
+  const auto write_seconds =
+      std::chrono::duration<double>(statistics.write_time).count();
+  if (write_seconds > 0) {
+    statistics.bytes_per_second = statistics.written_bytes / write_seconds;
+  }
+  return statistics;
+}
+
+void FileWritingStage::run_writer() {
+  tracing::set_thread_name("File Writer");
+  while (true) {
+    auto lock = std::unique_lock(mutex_);
+    queue_changed_.wait(lock,
+                        [this]() { return is_stopping_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+
+    auto file = std::move(queue_.front());
+    queue_.pop_front();
+    writing_files_count_++;
+    const auto queued_size = file.data.size();
+    lock.unlock();
+
+    std::size_t written_size = 0;
+    auto write_time = Duration::zero();
+    std::exception_ptr error;
+    try {
+      if (file.serialize) {
+        file.data = file.serialize();
+      }
+      const auto start_time = std::chrono::steady_clock::now();
+      written_size = write_file(file);
+      write_time = std::chrono::duration_cast<Duration>(
+          std::chrono::steady_clock::now() - start_time);
+    } catch (const std::exception&) {
+      error = std::current_exception();
+    }
+
+    lock.lock();
+    writing_files_count_--;
+    queued_bytes_ -= queued_size;
+    if (error) {
+      if (!error_) {
+        error_ = error;
+      }
+    } else {
+      statistics_.files_count++;
+      statistics_.written_bytes += written_size;
+      statistics_.write_time += write_time;
+      if (fsync_policy_ == FsyncPolicy::OnFinish) {
+        unsynced_file_paths_.push_back(std::move(file.path));
+      }
+    }
+    lock.unlock();
+    queue_changed_.notify_all();
+  }
+}
+
+std::size_t FileWritingStage::write_file(File& file) {
+  if (file.write_file) {
+    const tracing::Span span("Write File", "output");
+    file.write_file(file.path);
+    if (fsync_policy_ == FsyncPolicy::EveryFile) {
+      sync_file(file.path);
+    }
+    return std::filesystem::file_size(file.path);
+  }
+
+  const tracing::Span span("Write File", "output", "bytes", file.data.size());
+  auto file_descriptor =
+      FileDescriptor(file.path, O_WRONLY | O_CREAT | O_TRUNC);
+
+  std::size_t offset = 0;
+  while (offset < file.data.size()) {
+    const auto written_size =
+        ::pwrite(file_descriptor.get(), file.data.data() + offset,
+                 file.data.size() - offset, offset);
+    if (written_size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("Failed to write file " + file.path);
+    }
+    offset += written_size;
+  }
+
+  if (fsync_policy_ == FsyncPolicy::EveryFile) {
+    sync_file(file_descriptor, file.path);
+  }
+  file_descriptor.close();
+  return file.data.size();
+}
+}  // namespace uni_course_cpp
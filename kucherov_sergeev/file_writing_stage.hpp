@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace uni_course_cpp {
+// Writes files on its own threads, so the producers only pay for queueing a
+// buffer or a serializer. The queue is bounded by the size of the queued
+// buffers in bytes, enqueue() blocks while it is full. Serializers aren't
+// counted, they are expected to hold what they serialize anyway.
+class FileWritingStage {
+ public:
+  using Duration = std::chrono::nanoseconds;
+  // Called on a writer thread, returns the contents of the file
+  using SerializeCallback = std::function<std::string()>;
+  // Called on a writer thread, writes the whole file at the given path, for
+  // serializers doing their own output
+  using WriteFileCallback = std::function<void(const std::string& file_path)>;
+
+  static constexpr std::size_t kDefaultMaxQueuedBytes = 256 << 20;
+
+  enum class FsyncPolicy {
+    // Leave flushing to the kernel
+    None,
+    // fsync every file before closing it, the files of write file
+    // callbacks are reopened for it once written
+    EveryFile,
+    // fsync all written files in finish()
+    OnFinish
+  };
+
+  struct Statistics {
+    std::size_t files_count = 0;
+    std::uint64_t written_bytes = 0;
+    std::size_t queue_depth = 0;
+    std::size_t max_queue_depth = 0;
+    std::size_t queued_bytes = 0;
+    // Total time the writer threads spent in file calls, including the
+    // write file callbacks
+    Duration write_time = Duration::zero();
+    double bytes_per_second = 0;
+  };
+
+  explicit FileWritingStage(
+      int threads_count,
+      std::size_t max_queued_bytes = kDefaultMaxQueuedBytes,
+      FsyncPolicy fsync_policy = FsyncPolicy::None);
+  ~FileWritingStage();
+
+  FileWritingStage(const FileWritingStage& other) = delete;
+  void operator=(const FileWritingStage& other) = delete;
+
+  void enqueue(std::string file_path, std::string data);
+  void enqueue(std::string file_path, SerializeCallback serialize);
+  void enqueue(std::string file_path, WriteFileCallback write_file);
+
+  // Waits until every queued file is written and applies the fsync policy.
+  // Rethrows the first write error. The stage can be used again afterwards.
+  void finish();
+
+  Statistics get_statistics() const;
+
+ private:
+  struct File {
+    std::string path;
+    std::string data;
+    SerializeCallback serialize;
+    WriteFileCallback write_file;
+  };
+
+  void push(File&& file);
+  void run_writer();
+  // Returns the size of the written file
+  std::size_t write_file(File& file);
+
+  const std::size_t max_queued_bytes_;
+  const FsyncPolicy fsync_policy_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable queue_changed_;
+  std::deque<File> queue_;
+  std::size_t queued_bytes_ = 0;
+  int writing_files_count_ = 0;
+  bool is_stopping_ = false;
+  std::exception_ptr error_;
+  std::vector<std::string> unsynced_file_paths_;
+  Statistics statistics_;
+
+  std::vector<std::thread> threads_;
+};
+}  // namespace uni_course_cpp
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <ctime>
+
+#include "generation_statistics.hpp"
+
+namespace uni_course_cpp {
+namespace {
+std::int64_t to_nanoseconds(GenerationStatistics::Duration duration) {
+  return duration.count();
+}
+
+GenerationStatistics::Duration from_nanoseconds(std::int64_t nanoseconds) {
+  return GenerationStatistics::Duration(nanoseconds);
+}
+}  // namespace
+
+GenerationStatistics::PhaseTimer::PhaseTimer(GenerationStatistics* statistics,
+                                             GenerationPhase phase)
+    : statistics_(statistics),
+      phase_(phase),
+      counters_scope_(statistics != nullptr
+                          ? &statistics->get_phase_counters(phase)
+                          : nullptr) {
+  if (statistics_ != nullptr) {
+    start_wall_time_ = std::chrono::steady_clock::now();
+    start_cpu_time_ = get_thread_cpu_time();
+  }
+}
+
+GenerationStatistics::PhaseTimer::~PhaseTimer() {
+  if (statistics_ != nullptr) {
+    statistics_->add_phase_time(
+        phase_,
+        std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() -
+                                             start_wall_time_),
+        get_thread_cpu_time() - start_cpu_time_);
+  }
+}
+
+GenerationStatistics::GenerationStatistics(int workers_count)
+    : worker_jobs_counts_(workers_count, 0) {}
+
+void GenerationStatistics::add_phase_time(GenerationPhase phase,
+                                          Duration wall_time,
+                                          Duration cpu_time) {
+  const auto phase_index = static_cast<int>(phase);
+  phase_wall_times_[phase_index] += to_nanoseconds(wall_time);
+  phase_cpu_times_[phase_index] += to_nanoseconds(cpu_time);
+}
+
+perf::CounterTotals& GenerationStatistics::get_phase_counters(
+    GenerationPhase phase) {
+  return phase_counters_[static_cast<int>(phase)];
+}
+
+void GenerationStatistics::add_lock_wait_time(LockKind lock_kind,
+                                              Duration wait_time) {
+  switch (lock_kind) {
+    case LockKind::GraphMutex:
+      graph_mutex_wait_time_ += to_nanoseconds(wait_time);
+      break;
+    case LockKind::JobsMutex:
+      jobs_mutex_wait_time_ += to_nanoseconds(wait_time);
+      break;
+    case LockKind::GreyJobsMutex:
+      grey_jobs_mutex_wait_time_ += to_nanoseconds(wait_time);
+      break;
+  }
+}
+
+void GenerationStatistics::add_queue_wait_time(Duration wait_time) {
+  queue_wait_time_ += to_nanoseconds(wait_time);
+}
+
+void GenerationStatistics::add_finished_job(int worker_index,
+                                            const Graph& graph) {
+  const std::lock_guard lock(jobs_mutex_);
+
+  worker_jobs_counts_.at(worker_index)++;
+  vertices_count_ += graph.get_vertices().size();
+  edges_count_ += graph.get_edges().size();
+}
+
+void GenerationStatistics::set_batch_time(Duration batch_time) {
+  batch_time_ = to_nanoseconds(batch_time);
+}
+
+GenerationStatistics::Snapshot GenerationStatistics::get_snapshot() const {
+  auto snapshot = Snapshot();
+
+  for (int i = 0; i < kGenerationPhasesCount; i++) {
+    snapshot.phase_times[i] = {from_nanoseconds(phase_wall_times_[i]),
+                               from_nanoseconds(phase_cpu_times_[i])};
+  }
+  snapshot.has_phase_counters = perf::is_enabled();
+  if (snapshot.has_phase_counters) {
+    for (int i = 0; i < kGenerationPhasesCount; i++) {
+      snapshot.phase_counters[i] = phase_counters_[i].get();
+    }
+  }
+  snapshot.batch_time = from_nanoseconds(batch_time_);
+  snapshot.queue_wait_time = from_nanoseconds(queue_wait_time_);
+  snapshot.graph_mutex_wait_time = from_nanoseconds(graph_mutex_wait_time_);
+  snapshot.jobs_mutex_wait_time = from_nanoseconds(jobs_mutex_wait_time_);
+  snapshot.grey_jobs_mutex_wait_time =
+      from_nanoseconds(grey_jobs_mutex_wait_time_);
+
+  {
+    const std::lock_guard lock(jobs_mutex_);
+    snapshot.vertices_count = vertices_count_;
+    snapshot.edges_count = edges_count_;
+    snapshot.worker_jobs_counts = worker_jobs_counts_;
+  }
+
+  const auto batch_seconds =
+      std::chrono::duration<double>(snapshot.batch_time).count();
+  if (batch_seconds > 0) {
+    snapshot.vertices_per_second = snapshot.vertices_count / batch_seconds;
+    snapshot.edges_per_second = snapshot.edges_count / batch_seconds;
+  }
+
+  return snapshot;
+}
+
+void GenerationStatistics::reset() {
+  for (int i = 0; i < kGenerationPhasesCount; i++) {
+    phase_wall_times_[i] = 0;
+    phase_cpu_times_[i] = 0;
+    phase_counters_[i].reset();
+  }
+  graph_mutex_wait_time_ = 0;
+  jobs_mutex_wait_time_ = 0;
+  grey_jobs_mutex_wait_time_ = 0;
+  queue_wait_time_ = 0;
+  batch_time_ = 0;
+
+  const std::lock_guard lock(jobs_mutex_);
+  std::fill(worker_jobs_counts_.begin(), worker_jobs_counts_.end(), 0);
+  vertices_count_ = 0;
+  edges_count_ = 0;
+}
+
+GenerationStatistics::Duration get_thread_cpu_time() {
+#if defined(__unix__) || defined(__APPLE__)
+  timespec cpu_time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time) == 0) {
+    return std::chrono::seconds(cpu_time.tv_sec) +
+           std::chrono::nanoseconds(cpu_time.tv_nsec);
+  }
+#endif
+  return GenerationStatistics::Duration::zero();
+}
+
+std::unique_lock<std::mutex> lock_measured(
+    std::mutex& mutex,
+    GenerationStatistics* statistics,
+    GenerationStatistics::LockKind lock_kind) {
+  if (statistics == nullptr) {
+    return std::unique_lock(mutex);
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  auto lock = std::unique_lock(mutex);
+  statistics->add_lock_wait_time(
+      lock_kind, std::chrono::duration_cast<GenerationStatistics::Duration>(
+                     std::chrono::steady_clock::now() - start_time));
+
+  return lock;
+}
+}  // namespace uni_course_cpp
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "graph.hpp"
+#include "perf_counters.hpp"
+
+namespace uni_course_cpp {
+enum class GenerationPhase { Grey, Green, Yellow, Red };
+inline constexpr int kGenerationPhasesCount = 4;
+
+// Thread-safe counters of the generation batch. Everything is accumulated
+// over all graphs, so the times of parallel phases add up.
+class GenerationStatistics {
+ public:
+  using Duration = std::chrono::nanoseconds;
+
+  // JobsMutex guards the job queue of the controller, GreyJobsMutex the
+  // grey branches of a single graph
+  enum class LockKind { GraphMutex, JobsMutex, GreyJobsMutex };
+
+  struct PhaseTimes {
+    Duration wall_time = Duration::zero();
+    Duration cpu_time = Duration::zero();
+  };
+
+  struct Snapshot {
+    std::array<PhaseTimes, kGenerationPhasesCount> phase_times = {};
+    // Filled only while perf counters are enabled
+    bool has_phase_counters = false;
+    std::array<perf::Values, kGenerationPhasesCount> phase_counters = {};
+    Duration batch_time = Duration::zero();
+    Duration queue_wait_time = Duration::zero();
+    Duration graph_mutex_wait_time = Duration::zero();
+    Duration jobs_mutex_wait_time = Duration::zero();
+    Duration grey_jobs_mutex_wait_time = Duration::zero();
+    std::int64_t vertices_count = 0;
+    std::int64_t edges_count = 0;
+    double vertices_per_second = 0;
+    double edges_per_second = 0;
+    std::vector<int> worker_jobs_counts;
+  };
+
+  // Measures wall and CPU time and the perf counters of the current thread
+  // until destruction. Does nothing without statistics.
+  class PhaseTimer {
+   public:
+    PhaseTimer(GenerationStatistics* statistics, GenerationPhase phase);
+    ~PhaseTimer();
+
+    PhaseTimer(const PhaseTimer& other) = delete;
+    void operator=(const PhaseTimer& other) = delete;
+
+   private:
+    GenerationStatistics* statistics_;
+    GenerationPhase phase_;
+    std::chrono::steady_clock::time_point start_wall_time_;
+    Duration start_cpu_time_ = Duration::zero();
+    perf::Scope counters_scope_;
+  };
+
+  explicit GenerationStatistics(int workers_count);
+
+  void add_phase_time(GenerationPhase phase,
+                      Duration wall_time,
+                      Duration cpu_time);
+  // For threads which measure a phase without a timer
+  perf::CounterTotals& get_phase_counters(GenerationPhase phase);
+  void add_lock_wait_time(LockKind lock_kind, Duration wait_time);
+  void add_queue_wait_time(Duration wait_time);
+  void add_finished_job(int worker_index, const Graph& graph);
+  void set_batch_time(Duration batch_time);
+
+  Snapshot get_snapshot() const;
+  void reset();
+
+ private:
+  std::array<std::atomic<std::int64_t>, kGenerationPhasesCount>
+      phase_wall_times_ = {};
+  std::array<std::atomic<std::int64_t>, kGenerationPhasesCount>
+      phase_cpu_times_ = {};
+  std::array<perf::CounterTotals, kGenerationPhasesCount> phase_counters_;
+  std::atomic<std::int64_t> graph_mutex_wait_time_ = 0;
+  std::atomic<std::int64_t> jobs_mutex_wait_time_ = 0;
+  std::atomic<std::int64_t> grey_jobs_mutex_wait_time_ = 0;
+  std::atomic<std::int64_t> queue_wait_time_ = 0;
+  std::atomic<std::int64_t> batch_time_ = 0;
+
+  mutable std::mutex jobs_mutex_;
+  std::vector<int> worker_jobs_counts_;
+  std::int64_t vertices_count_ = 0;
+  std::int64_t edges_count_ = 0;
+};
+
+// CPU time consumed by the calling thread, zero where it isn't supported
+GenerationStatistics::Duration get_thread_cpu_time();
+
+// Locks the mutex and accounts the time spent waiting for it
+std::unique_lock<std::mutex> lock_measured(
+    std::mutex& mutex,
+    GenerationStatistics* statistics,
+    GenerationStatistics::LockKind lock_kind);
+}  // namespace uni_course_cpp
@@ -1,9 +1,68 @@
 #include <algorithm>
 #include <stdexcept>
+#include <utility>
 
 #include "graph.hpp"
 
 namespace uni_course_cpp {
+namespace {
+template <typename Ids>
+std::size_t get_slack_bytes(const Ids& ids) {
+  return (ids.capacity() - ids.size()) * sizeof(typename Ids::value_type);
+}
+}  // namespace
+
+Graph::Graph() {
+  depth_vertices_list_.emplace_back();
+}
+
+Graph::Graph(const Graph& other)
+    : next_free_vertex_id_(other.next_free_vertex_id_),
+      next_free_edge_id_(other.next_free_edge_id_),
+      vertices_(other.vertices_,
+                CountingAllocator<VertexId>(&memory_counters_->vertices)),
+      edges_(other.edges_, CountingAllocator<EdgeId>(&memory_counters_->edges)),
+      adjacency_list_(
+          other.adjacency_list_,
+          CountingAllocator<VertexId>(&memory_counters_->adjacency)),
+      vertex_depths_list_(
+          other.vertex_depths_list_,
+          CountingAllocator<VertexId>(&memory_counters_->depth_index)),
+      depth_vertices_list_(
+          other.depth_vertices_list_,
+          CountingAllocator<VertexId>(&memory_counters_->depth_index)) {
+  // Copy assignment keeps the allocators of the destination
+  color_edge_ids_lists_ = other.color_edge_ids_lists_;
+}
+
+Graph::Graph(Graph&& other) noexcept : Graph() {
+  *this = std::move(other);
+}
+
+Graph& Graph::operator=(const Graph& other) {
+  return *this = Graph(other);
+}
+
+Graph& Graph::operator=(Graph&& other) noexcept {
+  std::swap(memory_counters_, other.memory_counters_);
+  std::swap(next_free_vertex_id_, other.next_free_vertex_id_);
+  std::swap(next_free_edge_id_, other.next_free_edge_id_);
+  vertices_.swap(other.vertices_);
+  edges_.swap(other.edges_);
+  adjacency_list_.swap(other.adjacency_list_);
+  vertex_depths_list_.swap(other.vertex_depths_list_);
+  depth_vertices_list_.swap(other.depth_vertices_list_);
+  color_edge_ids_lists_.swap(other.color_edge_ids_lists_);
+  return *this;
+}
+
+void Graph::reserve(std::size_t vertices_count, std::size_t edges_count) {
+  vertices_.reserve(vertices_count);
+  adjacency_list_.reserve(vertices_count);
+  vertex_depths_list_.reserve(vertices_count);
+  edges_.reserve(edges_count);
+}
+
 Graph::VertexId Graph::add_vertex() {
   const VertexId vertex_id = get_new_vertex_id();
 
@@ -25,6 +84,7 @@ Graph::EdgeId Graph::add_edge(Graph::VertexId from_vertex_id,
   edges_.insert({edge_id, Graph::Edge(edge_id, from_vertex_id, to_vertex_id,
                                       edge_color)});
 
+  color_edge_ids_lists_[static_cast<int>(edge_color)].push_back(edge_id);
   adjacency_list_[from_vertex_id].push_back(edge_id);
   if (to_vertex_id != from_vertex_id) {
     adjacency_list_[to_vertex_id].push_back(edge_id);
@@ -38,20 +98,20 @@ Graph::Depth Graph::get_depth() const {
                                         : (depth_vertices_list_.size() - 1);
 }
 
-const std::vector<Graph::VertexId>& Graph::get_depth_vertex_ids(
+const Graph::VertexIds& Graph::get_depth_vertex_ids(
     Graph::Depth depth) const {
   if (depth > get_depth()) {
-    static const std::vector<VertexId> empty_result;
+    static const VertexIds empty_result;
     return empty_result;
   }
 
   return depth_vertices_list_.at(depth);
 }
 
-const std::vector<Graph::EdgeId>& Graph::get_connected_edge_ids(
+const Graph::EdgeIds& Graph::get_connected_edge_ids(
     Graph::VertexId vertex_id) const {
   if (adjacency_list_.find(vertex_id) == adjacency_list_.end()) {
-    static const std::vector<Graph::EdgeId> empty_result;
+    static const EdgeIds empty_result;
     return empty_result;
   }
 
@@ -79,15 +139,55 @@ Graph::Depth Graph::get_vertex_depth(Graph::VertexId vertex_id) const {
   return vertex_depths_list_.at(vertex_id);
 }
 
-const std::unordered_map<Graph::VertexId, Graph::Vertex>& Graph::get_vertices()
+const Graph::HashMap<Graph::VertexId, Graph::Vertex>& Graph::get_vertices()
     const {
   return vertices_;
 }
 
-const std::unordered_map<Graph::EdgeId, Graph::Edge>& Graph::get_edges() const {
+const Graph::HashMap<Graph::EdgeId, Graph::Edge>& Graph::get_edges() const {
   return edges_;
 }
 
+const Graph::EdgeIds& Graph::get_color_edge_ids(
+    Graph::Edge::Color color) const {
+  return color_edge_ids_lists_.at(static_cast<int>(color));
+}
+
+Graph::MemoryUsage Graph::get_memory_usage() const {
+  auto memory_usage = MemoryUsage();
+  memory_usage.vertices_bytes = memory_counters_->vertices.allocated_bytes;
+  memory_usage.edges_bytes = memory_counters_->edges.allocated_bytes;
+  memory_usage.adjacency_bytes = memory_counters_->adjacency.allocated_bytes;
+  memory_usage.depth_index_bytes =
+      memory_counters_->depth_index.allocated_bytes;
+  memory_usage.color_index_bytes =
+      memory_counters_->color_index.allocated_bytes;
+  for (const auto* const counter :
+       {&memory_counters_->vertices, &memory_counters_->edges,
+        &memory_counters_->adjacency, &memory_counters_->depth_index,
+        &memory_counters_->color_index}) {
+    memory_usage.hash_bucket_bytes += counter->hash_bucket_bytes;
+  }
+
+  for (const auto& [vertex_id, edge_ids] : adjacency_list_) {
+    memory_usage.slack_bytes += get_slack_bytes(edge_ids);
+  }
+  memory_usage.slack_bytes += get_slack_bytes(depth_vertices_list_);
+  for (const auto& vertex_ids : depth_vertices_list_) {
+    memory_usage.slack_bytes += get_slack_bytes(vertex_ids);
+  }
+  for (const auto& edge_ids : color_edge_ids_lists_) {
+    memory_usage.slack_bytes += get_slack_bytes(edge_ids);
+  }
+
+  memory_usage.total_bytes =
+      sizeof(Graph) + sizeof(MemoryCounters) + memory_usage.vertices_bytes +
+      memory_usage.edges_bytes + memory_usage.adjacency_bytes +
+      memory_usage.depth_index_bytes + memory_usage.color_index_bytes +
+      memory_usage.hash_bucket_bytes;
+  return memory_usage;
+}
+
 Graph::VertexId Graph::get_new_vertex_id() {
   return next_free_vertex_id_++;
 }
@@ -121,7 +221,7 @@ Graph::Edge::Color Graph::determine_edge_color(
 
 void Graph::set_vertex_depth(Graph::VertexId vertex_id, Graph::Depth depth) {
   while (get_depth() < depth) {
-    depth_vertices_list_.push_back({});
+    depth_vertices_list_.emplace_back();
   }
 
   if (vertex_depths_list_.find(vertex_id) != vertex_depths_list_.end()) {
@@ -137,4 +237,11 @@ void Graph::set_vertex_depth(Graph::VertexId vertex_id, Graph::Depth depth) {
   depth_vertices_list_[depth].push_back(vertex_id);
   vertex_depths_list_[vertex_id] = depth;
 }
+
+std::array<Graph::EdgeIds, Graph::Edge::kColorsCount>
+Graph::make_color_edge_ids_lists(AllocationCounter* counter) {
+  const auto allocator = CountingAllocator<EdgeId>(counter);
+  return {EdgeIds(allocator), EdgeIds(allocator), EdgeIds(allocator),
+          EdgeIds(allocator)};
+}
 }  // namespace uni_course_cpp
@@ -1,8 +1,16 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <scoped_allocator>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "counting_allocator.hpp"
+
 namespace uni_course_cpp {
 class Graph {
  public:
@@ -13,6 +21,7 @@ class Graph {
   struct Edge {
    public:
     enum class Color { Grey, Green, Yellow, Red };
+    static constexpr int kColorsCount = 4;
 
     Edge(EdgeId id, VertexId from_vertex_id, VertexId to_vertex_id, Color color)
         : id_(id),
@@ -41,25 +50,70 @@ class Graph {
     VertexId id_ = 0;
   };
 
+  // The containers count their allocations, see get_memory_usage()
+  template <typename Key, typename Value>
+  using HashMap = std::unordered_map<
+      Key,
+      Value,
+      std::hash<Key>,
+      std::equal_to<Key>,
+      CountingAllocator<std::pair<const Key, Value>>>;
+  using VertexIds = std::vector<VertexId, CountingAllocator<VertexId>>;
+  using EdgeIds = std::vector<EdgeId, CountingAllocator<EdgeId>>;
+
+  // Heap bytes by the structure holding them. The hash bucket arrays are
+  // left out of the structures, the slack is unused capacity of the id
+  // vectors and is included in them.
+  struct MemoryUsage {
+    std::size_t vertices_bytes = 0;
+    std::size_t edges_bytes = 0;
+    std::size_t adjacency_bytes = 0;
+    std::size_t depth_index_bytes = 0;
+    std::size_t color_index_bytes = 0;
+    std::size_t hash_bucket_bytes = 0;
+    std::size_t slack_bytes = 0;
+    // Everything above but the slack, plus the graph object itself
+    std::size_t total_bytes = 0;
+  };
+
+  Graph();
+  Graph(const Graph& other);
+  // Leaves the other graph empty, with counters of its own for the
+  // containers it allocates later
+  Graph(Graph&& other) noexcept;
+  Graph& operator=(const Graph& other);
+  // Swaps the containers along with the counters they report to, as
+  // replacing the counters first would leave the old containers counting
+  // to freed memory
+  Graph& operator=(Graph&& other) noexcept;
+
+  // Pre-sizes the storage when the final size is known, e.g. on loading
+  void reserve(std::size_t vertices_count, std::size_t edges_count);
+
   VertexId add_vertex();
 
   EdgeId add_edge(VertexId from_vertex_id, VertexId to_vertex_id);
 
   Depth get_depth() const;
 
-  const std::vector<VertexId>& get_depth_vertex_ids(Depth depth) const;
+  const VertexIds& get_depth_vertex_ids(Depth depth) const;
 
-  const std::vector<EdgeId>& get_connected_edge_ids(VertexId vertex_id) const;
+  const EdgeIds& get_connected_edge_ids(VertexId vertex_id) const;
 
   bool is_vertices_connected(VertexId first_vertex_id,
                              VertexId second_vertex_id) const;
 
   Depth get_vertex_depth(VertexId vertex_id) const;
 
-  const std::unordered_map<Graph::VertexId, Graph::Vertex>& get_vertices()
-      const;
+  const HashMap<VertexId, Vertex>& get_vertices() const;
 
-  const std::unordered_map<Graph::EdgeId, Graph::Edge>& get_edges() const;
+  const HashMap<EdgeId, Edge>& get_edges() const;
+
+  // Ids of the edges of the color in increasing order
+  const EdgeIds& get_color_edge_ids(Edge::Color color) const;
+
+  // Takes a pass over the id vectors for the slack
+  MemoryUsage get_memory_usage() const;
 
  private:
   VertexId get_new_vertex_id();
@@ -71,13 +125,46 @@ class Graph {
 
   void set_vertex_depth(VertexId vertex_id, Depth depth);
 
+  static std::array<EdgeIds, Edge::kColorsCount> make_color_edge_ids_lists(
+      AllocationCounter* counter);
+
+  // Lives on the heap, so moved containers keep counting to the same place
+  struct MemoryCounters {
+    AllocationCounter vertices;
+    AllocationCounter edges;
+    AllocationCounter adjacency;
+    AllocationCounter depth_index;
+    AllocationCounter color_index;
+  };
+
+  // The nested vectors get the allocator of the outer container
+  template <typename T>
+  using NestedAllocator = std::scoped_allocator_adaptor<CountingAllocator<T>>;
+  using AdjacencyList = std::unordered_map<
+      VertexId,
+      EdgeIds,
+      std::hash<VertexId>,
+      std::equal_to<VertexId>,
+      NestedAllocator<std::pair<const VertexId, EdgeIds>>>;
+  using DepthVerticesList = std::vector<VertexIds, NestedAllocator<VertexIds>>;
+
+  // Declared first to outlive the containers
+  std::unique_ptr<MemoryCounters> memory_counters_ =
+      std::make_unique<MemoryCounters>();
   VertexId next_free_vertex_id_ = 0;
   EdgeId next_free_edge_id_ = 0;
-  std::unordered_map<VertexId, Vertex> vertices_;
-  std::unordered_map<EdgeId, Edge> edges_;
-  std::unordered_map<VertexId, std::vector<EdgeId>> adjacency_list_;
-  std::unordered_map<VertexId, Depth> vertex_depths_list_;
-  std::vector<std::vector<VertexId>> depth_vertices_list_ = {{}};
+  HashMap<VertexId, Vertex> vertices_{
+      CountingAllocator<VertexId>(&memory_counters_->vertices)};
+  HashMap<EdgeId, Edge> edges_{
+      CountingAllocator<EdgeId>(&memory_counters_->edges)};
+  AdjacencyList adjacency_list_{
+      CountingAllocator<VertexId>(&memory_counters_->adjacency)};
+  HashMap<VertexId, Depth> vertex_depths_list_{
+      CountingAllocator<VertexId>(&memory_counters_->depth_index)};
+  DepthVerticesList depth_vertices_list_{
+      CountingAllocator<VertexId>(&memory_counters_->depth_index)};
+  std::array<EdgeIds, Edge::kColorsCount> color_edge_ids_lists_ =
+      make_color_edge_ids_lists(&memory_counters_->color_index);
 };
 
 static constexpr Graph::Depth kGraphDefaultDepth = 1;
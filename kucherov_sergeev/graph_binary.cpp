@@ -0,0 +1,459 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "graph_binary.hpp"
+
+namespace uni_course_cpp {
+namespace binary {
+namespace {
+static_assert(sizeof(Graph::VertexId) == sizeof(std::int32_t));
+static_assert(sizeof(Graph::EdgeId) == sizeof(std::int32_t));
+static_assert(sizeof(Graph::Depth) == sizeof(std::int32_t));
+static_assert(sizeof(Header) == 32);
+static_assert(sizeof(PackedEdge) == 8);
+
+static constexpr std::size_t kSectionAlignment = 8;
+static constexpr int kColorShift = 30;
+static constexpr std::uint32_t kVertexIdMask = (1u << kColorShift) - 1;
+static constexpr std::uint32_t kMaxDepth =
+    std::numeric_limits<Graph::Depth>::max();
+static constexpr std::uint64_t kMaxEdgesCount =
+    std::numeric_limits<Graph::EdgeId>::max();
+
+struct Layout {
+  std::size_t depth_table_offset = 0;
+  std::size_t depth_vertex_ids_offset = 0;
+  std::size_t vertex_depths_offset = 0;
+  std::size_t adjacency_offsets_offset = 0;
+  std::size_t adjacency_edge_ids_offset = 0;
+  std::size_t edges_offset = 0;
+  std::size_t size = 0;
+};
+
+// Every step fails instead of wrapping around, the counts may come from a
+// corrupted file
+bool align_size(std::size_t& size) {
+  if (size > std::numeric_limits<std::size_t>::max() - kSectionAlignment) {
+    return false;
+  }
+  size = (size + kSectionAlignment - 1) / kSectionAlignment *
+         kSectionAlignment;
+  return true;
+}
+
+bool add_section(std::size_t& size,
+                 std::uint64_t elements_count,
+                 std::size_t element_size) {
+  if (elements_count >
+      (std::numeric_limits<std::size_t>::max() - size) / element_size) {
+    return false;
+  }
+  size += elements_count * element_size;
+  return true;
+}
+
+std::optional<Layout> get_layout(const Header& header) {
+  if (header.depth > kMaxDepth || header.vertices_count > kVertexIdMask ||
+      header.edges_count > kMaxEdgesCount) {
+    return std::nullopt;
+  }
+
+  auto layout = Layout();
+  std::size_t offset = sizeof(Header);
+  layout.depth_table_offset = offset;
+  if (!add_section(offset, std::uint64_t{header.depth} + 2,
+                   sizeof(std::uint32_t)) ||
+      !align_size(offset)) {
+    return std::nullopt;
+  }
+  layout.depth_vertex_ids_offset = offset;
+  if (!add_section(offset, header.vertices_count, sizeof(Graph::VertexId)) ||
+      !align_size(offset)) {
+    return std::nullopt;
+  }
+  layout.vertex_depths_offset = offset;
+  if (!add_section(offset, header.vertices_count, sizeof(Graph::Depth)) ||
+      !align_size(offset)) {
+    return std::nullopt;
+  }
+  layout.adjacency_offsets_offset = offset;
+  if (!add_section(offset, std::uint64_t{header.vertices_count} + 1,
+                   sizeof(std::uint64_t)) ||
+      !align_size(offset)) {
+    return std::nullopt;
+  }
+  layout.adjacency_edge_ids_offset = offset;
+  if (!add_section(offset, header.adjacency_size, sizeof(Graph::EdgeId)) ||
+      !align_size(offset)) {
+    return std::nullopt;
+  }
+  layout.edges_offset = offset;
+  if (!add_section(offset, header.edges_count, sizeof(PackedEdge))) {
+    return std::nullopt;
+  }
+  layout.size = offset;
+  return layout;
+}
+
+// Offsets into a section of section_size elements, starting at zero
+template <typename Offset>
+bool is_offsets_table_valid(const Offset* offsets,
+                            std::size_t offsets_count,
+                            std::uint64_t section_size) {
+  if (offsets[0] != 0 || offsets[offsets_count - 1] != section_size) {
+    return false;
+  }
+  for (std::size_t index = 1; index < offsets_count; index++) {
+    if (offsets[index] < offsets[index - 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename Id>
+bool is_ids_in_range(const Id* ids,
+                     std::size_t ids_count,
+                     std::uint64_t bound) {
+  for (std::size_t index = 0; index < ids_count; index++) {
+    if (ids[index] < 0 || static_cast<std::uint64_t>(ids[index]) >= bound) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Span of the ids between two offsets read from the file
+template <typename Id, typename Offset>
+IdSpan<Id> make_checked_span(const Id* ids,
+                             Offset begin_offset,
+                             Offset end_offset,
+                             std::uint64_t ids_count) {
+  if (begin_offset > end_offset || end_offset > ids_count) {
+    throw std::runtime_error("Corrupted binary graph file");
+  }
+  return IdSpan<Id>(ids + begin_offset, ids + end_offset);
+}
+
+class SectionWriter {
+ public:
+  explicit SectionWriter(BufferedWriter& writer) : writer_(writer) {}
+
+  template <typename T>
+  void write(const T& value) {
+    writer_.write(
+        std::string_view(reinterpret_cast<const char*>(&value), sizeof(T)));
+    offset_ += sizeof(T);
+  }
+
+  void start_section(std::size_t section_offset) {
+    while (offset_ < section_offset) {
+      writer_.write('\0');
+      offset_++;
+    }
+  }
+
+ private:
+  BufferedWriter& writer_;
+  std::size_t offset_ = 0;
+};
+
+std::uint32_t pack_to_vertex_id(Graph::VertexId to_vertex_id,
+                                Graph::Edge::Color color) {
+  return static_cast<std::uint32_t>(to_vertex_id) |
+         (static_cast<std::uint32_t>(color) << kColorShift);
+}
+}  // namespace
+
+void write_graph(const Graph& graph, BufferedWriter& output_writer) {
+  const auto& vertices = graph.get_vertices();
+  const auto& edges = graph.get_edges();
+  const Graph::VertexId vertices_count = vertices.size();
+  const Graph::EdgeId edges_count = edges.size();
+
+  if (static_cast<std::uint32_t>(vertices_count) > kVertexIdMask) {
+    throw std::runtime_error("Too many vertices for the binary format");
+  }
+
+  std::uint64_t adjacency_size = 0;
+  for (Graph::VertexId vertex_id = 0; vertex_id < vertices_count;
+       vertex_id++) {
+    if (vertices.find(vertex_id) == vertices.end()) {
+      throw std::runtime_error("Vertex ids must be dense");
+    }
+    adjacency_size += graph.get_connected_edge_ids(vertex_id).size();
+  }
+
+  auto header = Header();
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.depth = graph.get_depth();
+  header.vertices_count = vertices_count;
+  header.edges_count = edges_count;
+  header.adjacency_size = adjacency_size;
+  const auto layout = get_layout(header).value();
+
+  auto writer = SectionWriter(output_writer);
+  writer.write(header);
+
+  writer.start_section(layout.depth_table_offset);
+  std::uint32_t depth_offset = 0;
+  for (Graph::Depth depth = 0; depth <= graph.get_depth(); depth++) {
+    writer.write(depth_offset);
+    depth_offset += graph.get_depth_vertex_ids(depth).size();
+  }
+  writer.write(depth_offset);
+
+  writer.start_section(layout.depth_vertex_ids_offset);
+  for (Graph::Depth depth = 0; depth <= graph.get_depth(); depth++) {
+    for (const auto vertex_id : graph.get_depth_vertex_ids(depth)) {
+      writer.write(vertex_id);
+    }
+  }
+
+  writer.start_section(layout.vertex_depths_offset);
+  for (Graph::VertexId vertex_id = 0; vertex_id < vertices_count;
+       vertex_id++) {
+    writer.write(graph.get_vertex_depth(vertex_id));
+  }
+
+  writer.start_section(layout.adjacency_offsets_offset);
+  std::uint64_t adjacency_offset = 0;
+  for (Graph::VertexId vertex_id = 0; vertex_id < vertices_count;
+       vertex_id++) {
+    writer.write(adjacency_offset);
+    adjacency_offset += graph.get_connected_edge_ids(vertex_id).size();
+  }
+  writer.write(adjacency_offset);
+
+  writer.start_section(layout.adjacency_edge_ids_offset);
+  for (Graph::VertexId vertex_id = 0; vertex_id < vertices_count;
+       vertex_id++) {
+    for (const auto edge_id : graph.get_connected_edge_ids(vertex_id)) {
+      writer.write(edge_id);
+    }
+  }
+
+  writer.start_section(layout.edges_offset);
+  for (Graph::EdgeId edge_id = 0; edge_id < edges_count; edge_id++) {
+    const auto edge_iterator = edges.find(edge_id);
+    if (edge_iterator == edges.end()) {
+      throw std::runtime_error("Edge ids must be dense");
+    }
+    const auto& edge = edge_iterator->second;
+    writer.write(PackedEdge{
+        edge.from_vertex_id(),
+        pack_to_vertex_id(edge.to_vertex_id(), edge.color())});
+  }
+
+  output_writer.flush();
+}
+
+void write_graph(const Graph& graph, const std::string& file_path) {
+  auto file_writer = FileWriter(file_path);
+  write_graph(graph, file_writer);
+  file_writer.close();
+}
+
+MappedGraph::MappedGraph(const std::string& file_path) {
+  const int file_descriptor = ::open(file_path.c_str(), O_RDONLY);
+  if (file_descriptor == -1) {
+    throw std::runtime_error("Failed to open file " + file_path);
+  }
+
+  struct stat file_stat;
+  if (::fstat(file_descriptor, &file_stat) != 0 ||
+      static_cast<std::size_t>(file_stat.st_size) < sizeof(Header)) {
+    ::close(file_descriptor);
+    throw std::runtime_error("Invalid binary graph file " + file_path);
+  }
+
+  size_ = file_stat.st_size;
+  data_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, file_descriptor, 0);
+  ::close(file_descriptor);
+  if (data_ == MAP_FAILED) {
+    data_ = nullptr;
+    throw std::runtime_error("Failed to map file " + file_path);
+  }
+
+  const auto* const bytes = static_cast<const char*>(data_);
+  header_ = reinterpret_cast<const Header*>(bytes);
+  const bool is_header_valid =
+      std::memcmp(header_->magic, kMagic, sizeof(kMagic)) == 0 &&
+      header_->version == kVersion;
+  const auto layout =
+      is_header_valid ? get_layout(*header_) : std::optional<Layout>();
+  if (!layout || layout->size > size_) {
+    unmap();
+    throw std::runtime_error("Invalid binary graph file " + file_path);
+  }
+
+  depth_table_ = reinterpret_cast<const std::uint32_t*>(
+      bytes + layout->depth_table_offset);
+  depth_vertex_ids_ = reinterpret_cast<const Graph::VertexId*>(
+      bytes + layout->depth_vertex_ids_offset);
+  vertex_depths_ = reinterpret_cast<const Graph::Depth*>(
+      bytes + layout->vertex_depths_offset);
+  adjacency_offsets_ = reinterpret_cast<const std::uint64_t*>(
+      bytes + layout->adjacency_offsets_offset);
+  adjacency_edge_ids_ = reinterpret_cast<const Graph::EdgeId*>(
+      bytes + layout->adjacency_edge_ids_offset);
+  edges_ = reinterpret_cast<const PackedEdge*>(bytes + layout->edges_offset);
+}
+
+void MappedGraph::validate() const {
+  if (!is_sections_valid()) {
+    throw std::runtime_error("Corrupted binary graph file");
+  }
+}
+
+bool MappedGraph::is_sections_valid() const {
+  const std::uint64_t vertices_count = header_->vertices_count;
+  const std::uint64_t edges_count = header_->edges_count;
+  if (!is_offsets_table_valid(depth_table_, std::size_t{header_->depth} + 2,
+                              vertices_count) ||
+      !is_ids_in_range(depth_vertex_ids_, vertices_count, vertices_count) ||
+      !is_offsets_table_valid(adjacency_offsets_, vertices_count + 1,
+                              header_->adjacency_size) ||
+      !is_ids_in_range(adjacency_edge_ids_, header_->adjacency_size,
+                       edges_count)) {
+    return false;
+  }
+
+  for (std::size_t vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    const auto depth = vertex_depths_[vertex_id];
+    if (depth < 0 || depth > get_depth()) {
+      return false;
+    }
+  }
+
+  for (std::size_t edge_id = 0; edge_id < edges_count; edge_id++) {
+    const auto& packed_edge = edges_[edge_id];
+    if (packed_edge.from_vertex_id < 0 ||
+        static_cast<std::uint64_t>(packed_edge.from_vertex_id) >=
+            vertices_count ||
+        (packed_edge.to_vertex_id_and_color & kVertexIdMask) >=
+            vertices_count) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+MappedGraph::~MappedGraph() {
+  unmap();
+}
+
+MappedGraph::MappedGraph(MappedGraph&& other) noexcept {
+  *this = std::move(other);
+}
+
+MappedGraph& MappedGraph::operator=(MappedGraph&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    header_ = other.header_;
+    depth_table_ = other.depth_table_;
+    depth_vertex_ids_ = other.depth_vertex_ids_;
+    vertex_depths_ = other.vertex_depths_;
+    adjacency_offsets_ = other.adjacency_offsets_;
+    adjacency_edge_ids_ = other.adjacency_edge_ids_;
+    edges_ = other.edges_;
+  }
+  return *this;
+}
+
+void MappedGraph::unmap() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+
+IdSpan<Graph::VertexId> MappedGraph::get_depth_vertex_ids(
+    Graph::Depth depth) const {
+  if (depth < 0 || depth > get_depth()) {
+    return IdSpan<Graph::VertexId>(nullptr, nullptr);
+  }
+
+  return make_checked_span(depth_vertex_ids_, depth_table_[depth],
+                           depth_table_[depth + 1], get_vertices_count());
+}
+
+IdSpan<Graph::VertexId> MappedGraph::get_depth_range_vertex_ids(
+    Graph::Depth min_depth,
+    Graph::Depth max_depth) const {
+  min_depth = std::max(min_depth, 0);
+  max_depth = std::min(max_depth, get_depth());
+  if (min_depth > max_depth) {
+    return IdSpan<Graph::VertexId>(nullptr, nullptr);
+  }
+
+  return make_checked_span(depth_vertex_ids_, depth_table_[min_depth],
+                           depth_table_[max_depth + 1], get_vertices_count());
+}
+
+IdSpan<Graph::EdgeId> MappedGraph::get_connected_edge_ids(
+    Graph::VertexId vertex_id) const {
+  if (vertex_id < 0 ||
+      static_cast<std::size_t>(vertex_id) >= get_vertices_count()) {
+    return IdSpan<Graph::EdgeId>(nullptr, nullptr);
+  }
+
+  return make_checked_span(adjacency_edge_ids_, adjacency_offsets_[vertex_id],
+                           adjacency_offsets_[vertex_id + 1],
+                           header_->adjacency_size);
+}
+
+bool MappedGraph::is_vertices_connected(
+    Graph::VertexId first_vertex_id,
+    Graph::VertexId second_vertex_id) const {
+  for (const auto edge_id : get_connected_edge_ids(first_vertex_id)) {
+    const auto edge = get_edge(edge_id);
+    if ((first_vertex_id == edge.from_vertex_id() &&
+         second_vertex_id == edge.to_vertex_id()) ||
+        (first_vertex_id == edge.to_vertex_id() &&
+         second_vertex_id == edge.from_vertex_id())) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+Graph::Depth MappedGraph::get_vertex_depth(Graph::VertexId vertex_id) const {
+  if (vertex_id < 0 ||
+      static_cast<std::size_t>(vertex_id) >= get_vertices_count()) {
+    throw std::out_of_range("Vertex doesn't exist");
+  }
+
+  return vertex_depths_[vertex_id];
+}
+
+Graph::Edge MappedGraph::get_edge(Graph::EdgeId edge_id) const {
+  if (edge_id < 0 || static_cast<std::size_t>(edge_id) >= get_edges_count()) {
+    throw std::out_of_range("Edge doesn't exist");
+  }
+
+  const auto& packed_edge = edges_[edge_id];
+  return Graph::Edge(
+      edge_id, packed_edge.from_vertex_id,
+      packed_edge.to_vertex_id_and_color & kVertexIdMask,
+      static_cast<Graph::Edge::Color>(packed_edge.to_vertex_id_and_color >>
+                                      kColorShift));
+}
+}  // namespace binary
+}  // namespace uni_course_cpp
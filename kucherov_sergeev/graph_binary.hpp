@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "buffered_writer.hpp"
+#include "graph.hpp"
+
+namespace uni_course_cpp {
+namespace binary {
+// File layout, every section is aligned to 8 bytes:
+//   Header
+//   Depth table: uint32[depth + 2], vertices of depth d are
+//     depth_vertex_ids[table[d], table[d + 1])
+//   Depth vertex ids: int32[vertices_count]
+//   Vertex depths: int32[vertices_count], indexed by vertex id
+//   Adjacency offsets: uint64[vertices_count + 1]
+//   Adjacency edge ids: int32[adjacency_size]
+//   Edges: PackedEdge[edges_count], indexed by edge id
+// Ids are dense, as Graph allocates them in order.
+inline constexpr char kMagic[4] = {'U', 'C', 'G', 'B'};
+inline constexpr std::uint32_t kVersion = 1;
+
+struct Header {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t depth;
+  std::uint32_t vertices_count;
+  std::uint64_t edges_count;
+  std::uint64_t adjacency_size;
+};
+
+// Color is kept in the two high bits of the destination vertex id
+struct PackedEdge {
+  std::int32_t from_vertex_id;
+  std::uint32_t to_vertex_id_and_color;
+};
+
+// The writer must be at the beginning of the output
+void write_graph(const Graph& graph, BufferedWriter& writer);
+
+void write_graph(const Graph& graph, const std::string& file_path);
+
+template <typename Id>
+class IdSpan {
+ public:
+  IdSpan(const Id* begin, const Id* end) : begin_(begin), end_(end) {}
+
+  const Id* begin() const { return begin_; }
+  const Id* end() const { return end_; }
+  std::size_t size() const { return end_ - begin_; }
+  bool empty() const { return begin_ == end_; }
+  Id operator[](std::size_t index) const { return begin_[index]; }
+
+ private:
+  const Id* begin_;
+  const Id* end_;
+};
+
+// Maps the file and reads the graph in place, nothing is copied. Opening
+// only checks the header against the file size, so it doesn't depend on
+// the graph size. The accessors check the offsets they read, so a corrupted
+// file raises an error instead of being read out of bounds.
+class MappedGraph {
+ public:
+  explicit MappedGraph(const std::string& file_path);
+  ~MappedGraph();
+
+  MappedGraph(const MappedGraph& other) = delete;
+  void operator=(const MappedGraph& other) = delete;
+
+  MappedGraph(MappedGraph&& other) noexcept;
+  MappedGraph& operator=(MappedGraph&& other) noexcept;
+
+  Graph::Depth get_depth() const { return header_->depth; }
+  std::size_t get_vertices_count() const { return header_->vertices_count; }
+  std::size_t get_edges_count() const { return header_->edges_count; }
+
+  IdSpan<Graph::VertexId> get_depth_vertex_ids(Graph::Depth depth) const;
+
+  // Vertices are stored by depth, so a range of depths is a single span
+  // found through the depth table, the rest of the file isn't touched
+  IdSpan<Graph::VertexId> get_depth_range_vertex_ids(
+      Graph::Depth min_depth,
+      Graph::Depth max_depth) const;
+
+  IdSpan<Graph::EdgeId> get_connected_edge_ids(Graph::VertexId vertex_id) const;
+
+  bool is_vertices_connected(Graph::VertexId first_vertex_id,
+                             Graph::VertexId second_vertex_id) const;
+
+  Graph::Depth get_vertex_depth(Graph::VertexId vertex_id) const;
+
+  Graph::Edge get_edge(Graph::EdgeId edge_id) const;
+
+  // Scans every section and throws unless the offset tables are monotonic
+  // and every id and depth is in range. Reads the whole file.
+  void validate() const;
+
+ private:
+  void unmap();
+  bool is_sections_valid() const;
+
+  void* data_ = nullptr;
+  std::size_t size_ = 0;
+  const Header* header_ = nullptr;
+  const std::uint32_t* depth_table_ = nullptr;
+  const Graph::VertexId* depth_vertex_ids_ = nullptr;
+  const Graph::Depth* vertex_depths_ = nullptr;
+  const std::uint64_t* adjacency_offsets_ = nullptr;
+  const Graph::EdgeId* adjacency_edge_ids_ = nullptr;
+  const PackedEdge* edges_ = nullptr;
+};
+}  // namespace binary
+}  // namespace uni_course_cpp
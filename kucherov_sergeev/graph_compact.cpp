@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "buffered_writer.hpp"
+#include "graph_compact.hpp"
+
+namespace uni_course_cpp {
+namespace compact {
+namespace {
+static_assert(sizeof(Header) == 64);
+
+static constexpr std::size_t kBlockSize = 1 << 16;
+static constexpr std::size_t kMinMatchLength = 4;
+static constexpr int kHashBits = 14;
+static constexpr std::uint32_t kNoPosition =
+    std::numeric_limits<std::uint32_t>::max();
+
+struct EdgeRecord {
+  Graph::VertexId from_vertex_id = -1;
+  Graph::VertexId to_vertex_id = -1;
+  Graph::Edge::Color color = Graph::Edge::Color::Grey;
+};
+
+void write_varint(std::string& output, std::uint64_t value) {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<char>(value));
+}
+
+std::uint64_t to_zigzag(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t from_zigzag(std::uint64_t value) {
+  return static_cast<std::int64_t>(value >> 1) ^
+         -static_cast<std::int64_t>(value & 1);
+}
+
+template <typename T>
+void write_raw(std::string& output, const T& value) {
+  output.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+class ByteReader {
+ public:
+  explicit ByteReader(std::string_view data)
+      : current_(data.data()), end_(data.data() + data.size()) {}
+
+  bool at_end() const { return current_ == end_; }
+
+  std::uint64_t read_varint() {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (current_ == end_) {
+        fail();
+      }
+      const auto byte = static_cast<std::uint8_t>(*current_++);
+      value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    fail();
+  }
+
+  template <typename T>
+  T read_raw() {
+    T value;
+    std::memcpy(&value, read_bytes(sizeof(T)).data(), sizeof(T));
+    return value;
+  }
+
+  std::string_view read_bytes(std::size_t size) {
+    if (static_cast<std::size_t>(end_ - current_) < size) {
+      fail();
+    }
+    const auto bytes = std::string_view(current_, size);
+    current_ += size;
+    return bytes;
+  }
+
+  [[noreturn]] static void fail() {
+    throw std::runtime_error("Malformed compact graph");
+  }
+
+ private:
+  const char* current_;
+  const char* end_;
+};
+
+std::uint32_t hash_sequence(const char* data) {
+  std::uint32_t sequence;
+  std::memcpy(&sequence, data, sizeof(sequence));
+  return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+// Emits (literals count, literals, match length, match offset) sequences,
+// matches are looked up by the hash of their first bytes within the block.
+// A zero match length ends the block.
+void compress_block(std::string_view block,
+                    std::vector<std::uint32_t>& positions,
+                    std::string& output) {
+  std::fill(positions.begin(), positions.end(), kNoPosition);
+
+  std::size_t position = 0;
+  std::size_t literals_begin = 0;
+  while (position + kMinMatchLength <= block.size()) {
+    const auto hash = hash_sequence(block.data() + position);
+    const auto candidate = positions[hash];
+    positions[hash] = position;
+
+    if (candidate == kNoPosition ||
+        std::memcmp(block.data() + candidate, block.data() + position,
+                    kMinMatchLength) != 0) {
+      position++;
+      continue;
+    }
+
+    auto match_length = kMinMatchLength;
+    while (position + match_length < block.size() &&
+           block[candidate + match_length] == block[position + match_length]) {
+      match_length++;
+    }
+
+    write_varint(output, position - literals_begin);
+    output.append(block.data() + literals_begin, position - literals_begin);
+    write_varint(output, match_length - kMinMatchLength + 1);
+    write_varint(output, position - candidate);
+
+    position += match_length;
+    literals_begin = position;
+  }
+
+  write_varint(output, block.size() - literals_begin);
+  output.append(block.data() + literals_begin, block.size() - literals_begin);
+  write_varint(output, 0);
+}
+
+void decompress_block(std::string_view block,
+                      std::size_t raw_size,
+                      std::string& output) {
+  const auto block_begin = output.size();
+  auto reader = ByteReader(block);
+
+  while (true) {
+    const auto literals_count = reader.read_varint();
+    if (literals_count > raw_size - (output.size() - block_begin)) {
+      ByteReader::fail();
+    }
+    output.append(reader.read_bytes(literals_count));
+
+    const auto match_code = reader.read_varint();
+    if (match_code == 0) {
+      break;
+    }
+    const auto match_length = match_code + kMinMatchLength - 1;
+    const auto match_offset = reader.read_varint();
+    if (match_offset == 0 || match_offset > output.size() - block_begin ||
+        match_length > raw_size - (output.size() - block_begin)) {
+      ByteReader::fail();
+    }
+    // Byte by byte, as the match may overlap the bytes it produces
+    const auto match_begin = output.size() - match_offset;
+    for (std::size_t i = 0; i < match_length; i++) {
+      output.push_back(output[match_begin + i]);
+    }
+  }
+
+  if (output.size() - block_begin != raw_size || !reader.at_end()) {
+    ByteReader::fail();
+  }
+}
+
+// Blocks are framed as (raw size, stored size, bytes), a block that doesn't
+// shrink is stored as is
+std::string compress(std::string_view data) {
+  auto output = std::string();
+  auto compressed_block = std::string();
+  auto positions = std::vector<std::uint32_t>(1 << kHashBits);
+
+  for (std::size_t begin = 0; begin < data.size(); begin += kBlockSize) {
+    const auto block = data.substr(begin, kBlockSize);
+    compressed_block.clear();
+    compress_block(block, positions, compressed_block);
+
+    const auto stored_block = compressed_block.size() < block.size()
+                                  ? std::string_view(compressed_block)
+                                  : block;
+    write_raw(output, static_cast<std::uint32_t>(block.size()));
+    write_raw(output, static_cast<std::uint32_t>(stored_block.size()));
+    output.append(stored_block);
+  }
+
+  return output;
+}
+
+std::string decompress(std::string_view data) {
+  auto output = std::string();
+  auto reader = ByteReader(data);
+
+  while (!reader.at_end()) {
+    const auto raw_size = reader.read_raw<std::uint32_t>();
+    const auto stored_size = reader.read_raw<std::uint32_t>();
+    if (raw_size > kBlockSize || stored_size > raw_size) {
+      ByteReader::fail();
+    }
+
+    const auto block = reader.read_bytes(stored_size);
+    if (stored_size == raw_size) {
+      output.append(block);
+    } else {
+      decompress_block(block, raw_size, output);
+    }
+  }
+
+  return output;
+}
+
+void decode_stream(std::string_view stream,
+                   Graph::Edge::Color color,
+                   std::vector<EdgeRecord>& edges) {
+  auto reader = ByteReader(stream);
+  std::int64_t edge_id = -1;
+  std::int64_t from_vertex_id = 0;
+  std::int64_t to_vertex_id = 0;
+
+  while (!reader.at_end()) {
+    edge_id += static_cast<std::int64_t>(reader.read_varint()) + 1;
+    from_vertex_id += from_zigzag(reader.read_varint());
+    to_vertex_id += from_zigzag(reader.read_varint());
+
+    if (edge_id < 0 || static_cast<std::size_t>(edge_id) >= edges.size() ||
+        edges[edge_id].from_vertex_id != -1) {
+      throw std::runtime_error("Edge ids must be dense and unique");
+    }
+    edges[edge_id] = {static_cast<Graph::VertexId>(from_vertex_id),
+                      static_cast<Graph::VertexId>(to_vertex_id), color};
+  }
+}
+}  // namespace
+
+std::string encode_graph(const Graph& graph, Compression compression) {
+  const auto& edges = graph.get_edges();
+
+  struct Stream {
+    std::string data;
+    std::int64_t edge_id = -1;
+    std::int64_t from_vertex_id = 0;
+    std::int64_t to_vertex_id = 0;
+  };
+  Stream streams[Graph::Edge::kColorsCount];
+
+  for (Graph::EdgeId edge_id = 0;
+       static_cast<std::size_t>(edge_id) < edges.size(); edge_id++) {
+    const auto edge_iterator = edges.find(edge_id);
+    if (edge_iterator == edges.end()) {
+      throw std::runtime_error("Edge ids must be dense");
+    }
+    const auto& edge = edge_iterator->second;
+    auto& stream = streams[static_cast<int>(edge.color())];
+
+    write_varint(stream.data, edge_id - stream.edge_id - 1);
+    write_varint(stream.data,
+                 to_zigzag(edge.from_vertex_id() - stream.from_vertex_id));
+    write_varint(stream.data,
+                 to_zigzag(edge.to_vertex_id() - stream.to_vertex_id));
+    stream.edge_id = edge_id;
+    stream.from_vertex_id = edge.from_vertex_id();
+    stream.to_vertex_id = edge.to_vertex_id();
+  }
+
+  auto header = Header();
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.compression = compression;
+  header.depth = graph.get_depth();
+  header.vertices_count = graph.get_vertices().size();
+  header.edges_count = edges.size();
+
+  auto body = std::string();
+  for (int i = 0; i < Graph::Edge::kColorsCount; i++) {
+    header.stream_sizes[i] = streams[i].data.size();
+    body.append(streams[i].data);
+  }
+
+  auto output = std::string();
+  write_raw(output, header);
+  output.append(compression == Compression::Lz ? compress(body) : body);
+  return output;
+}
+
+Graph decode_graph(std::string_view data) {
+  auto reader = ByteReader(data);
+  const auto header = reader.read_raw<Header>();
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion ||
+      (header.compression != Compression::None &&
+       header.compression != Compression::Lz) ||
+      header.vertices_count >
+          static_cast<std::uint64_t>(std::numeric_limits<int>::max()) ||
+      header.edges_count >
+          static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+    throw std::runtime_error("Invalid compact graph header");
+  }
+
+  const auto stored_body = reader.read_bytes(data.size() - sizeof(Header));
+  const auto body = header.compression == Compression::Lz
+                        ? decompress(stored_body)
+                        : std::string(stored_body);
+
+  // Every edge takes at least three bytes
+  if (header.edges_count > body.size() / 3) {
+    ByteReader::fail();
+  }
+  auto edges = std::vector<EdgeRecord>(header.edges_count);
+  std::size_t stream_begin = 0;
+  for (int i = 0; i < Graph::Edge::kColorsCount; i++) {
+    if (header.stream_sizes[i] > body.size() - stream_begin) {
+      ByteReader::fail();
+    }
+    decode_stream(
+        std::string_view(body).substr(stream_begin, header.stream_sizes[i]),
+        static_cast<Graph::Edge::Color>(i), edges);
+    stream_begin += header.stream_sizes[i];
+  }
+  if (stream_begin != body.size()) {
+    ByteReader::fail();
+  }
+
+  const auto vertices_count = header.vertices_count;
+  auto graph = Graph();
+  graph.reserve(std::min<std::size_t>(vertices_count, edges.size() + 1),
+                edges.size());
+
+  std::size_t added_vertices_count = 0;
+  const auto add_vertices = [&graph, &added_vertices_count](
+                                std::size_t vertices_count) {
+    for (; added_vertices_count < vertices_count; added_vertices_count++) {
+      graph.add_vertex();
+    }
+  };
+
+  for (std::size_t edge_id = 0; edge_id < edges.size(); edge_id++) {
+    const auto& edge = edges[edge_id];
+    if (edge.from_vertex_id == -1) {
+      throw std::runtime_error("Edge ids must be dense and unique");
+    }
+    if (edge.from_vertex_id < 0 ||
+        static_cast<std::size_t>(edge.from_vertex_id) >= vertices_count ||
+        edge.to_vertex_id < 0 ||
+        static_cast<std::size_t>(edge.to_vertex_id) >= vertices_count) {
+      throw std::runtime_error("Edge " + std::to_string(edge_id) +
+                               " refers to a missing vertex");
+    }
+
+    add_vertices(std::max(edge.from_vertex_id, edge.to_vertex_id) + 1);
+    graph.add_edge(edge.from_vertex_id, edge.to_vertex_id);
+    if (graph.get_edges().at(edge_id).color() != edge.color) {
+      throw std::runtime_error("Edge " + std::to_string(edge_id) +
+                               " has an inconsistent color");
+    }
+  }
+  add_vertices(vertices_count);
+
+  if (static_cast<std::uint32_t>(graph.get_depth()) != header.depth) {
+    throw std::runtime_error("Graph has an inconsistent depth");
+  }
+
+  return graph;
+}
+
+void write_graph(const Graph& graph,
+                 const std::string& file_path,
+                 Compression compression) {
+  auto file_writer = FileWriter(file_path);
+  file_writer.write(encode_graph(graph, compression));
+  file_writer.close();
+}
+
+Graph read_graph(const std::string& file_path) {
+  auto file = std::ifstream(file_path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    throw std::runtime_error("Failed to open file " + file_path);
+  }
+
+  auto data = std::string(file.tellg(), '\0');
+  file.seekg(0);
+  if (!file.read(data.data(), data.size())) {
+    throw std::runtime_error("Failed to read file " + file_path);
+  }
+
+  return decode_graph(data);
+}
+}  // namespace compact
+}  // namespace uni_course_cpp
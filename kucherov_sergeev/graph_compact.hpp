@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "graph.hpp"
+
+namespace uni_course_cpp {
+namespace compact {
+// File layout:
+//   Header
+//   Body: the edge streams of every color one after another, stored as is
+//     or split into LZ compressed blocks
+// Every stream lists the edges of one color in id order as varint triples:
+// the id delta, the zigzag source delta and the zigzag destination delta,
+// all relative to the previous edge of the stream. Grey edges lead to the
+// next new vertex, so most of their deltas fit into a single byte.
+// Vertices aren't stored, the graph is rebuilt by adding edges in id order.
+inline constexpr char kMagic[4] = {'U', 'C', 'G', 'C'};
+inline constexpr std::uint32_t kVersion = 1;
+
+enum class Compression : std::uint32_t { None, Lz };
+
+struct Header {
+  char magic[4];
+  std::uint32_t version;
+  Compression compression;
+  std::uint32_t depth;
+  std::uint64_t vertices_count;
+  std::uint64_t edges_count;
+  std::uint64_t stream_sizes[Graph::Edge::kColorsCount];
+};
+
+std::string encode_graph(const Graph& graph,
+                         Compression compression = Compression::Lz);
+
+// Throws std::runtime_error if the data is malformed or inconsistent
+Graph decode_graph(std::string_view data);
+
+void write_graph(const Graph& graph,
+                 const std::string& file_path,
+                 Compression compression = Compression::Lz);
+
+Graph read_graph(const std::string& file_path);
+}  // namespace compact
+}  // namespace uni_course_cpp
@@ -1,42 +1,199 @@
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "graph_generation_controller.hpp"
+#include "graph_hashing.hpp"
+#include "logger.hpp"
+#include "tracing.hpp"
 
 namespace uni_course_cpp {
-void GraphGenerationController::Worker::start() {
+namespace {
+void bind_worker_thread(int worker_index,
+                        const std::optional<thread_affinity::CpuSet>& cpu_set) {
+  if (cpu_set.has_value() &&
+      !thread_affinity::bind_current_thread(cpu_set.value())) {
+    Logger::log<LogLevel::Warning>([worker_index]() {
+      return "Worker " + std::to_string(worker_index) +
+             ", CPU Binding Failed, the thread isn't pinned";
+    });
+  }
+}
+
+// A seeded batch gives every graph its own seed, so the graphs differ but
+// the batch is reproducible
+std::vector<GraphGenerator::Params> make_graphs_generator_params(
+    int graphs_count,
+    const GraphGenerator::Params& params) {
+  auto graphs_params = std::vector<GraphGenerator::Params>();
+  graphs_params.reserve(graphs_count);
+  for (int i = 0; i < graphs_count; i++) {
+    const auto seed = params.seed();
+    graphs_params.emplace_back(
+        params.depth(), params.new_vertices_count(),
+        seed.has_value() ? std::optional(seed.value() + i) : std::nullopt);
+  }
+  return graphs_params;
+}
+}  // namespace
+
+void GraphGenerationController::JobQueue::reset(std::vector<Job>&& jobs) {
+  std::stable_sort(jobs.begin(), jobs.end(),
+                   [](const Job& first_job, const Job& second_job) {
+                     return first_job.estimated_cost >
+                            second_job.estimated_cost;
+                   });
+
+  ring_ = std::move(jobs);
+  head_ = 0;
+  size_ = ring_.size();
+  remaining_cost_ = 0;
+  for (const auto& job : ring_) {
+    remaining_cost_ += job.estimated_cost;
+  }
+}
+
+void GraphGenerationController::JobQueue::pop_batch(
+    std::vector<Job>& batch,
+    int share,
+    std::size_t max_jobs_count) {
+  const double batch_cost = remaining_cost_ / share;
+  double current_batch_cost = 0;
+
+  while (size_ > 0 && batch.size() < max_jobs_count &&
+         (batch.empty() || current_batch_cost < batch_cost)) {
+    const auto& job = ring_[head_];
+    batch.push_back(job);
+    current_batch_cost += job.estimated_cost;
+    remaining_cost_ -= job.estimated_cost;
+    head_++;
+    size_--;
+  }
+}
+
+void GraphGenerationController::Worker::start(
+    const RunJobCallback& run_job_callback) {
   assert(state_ == State::Idle);
 
   state_ = State::Working;
+  run_job_callback_ = run_job_callback;
 
-  thread_ =
-      std::thread([&state = state_, &get_job_callback = get_job_callback_]() {
-        while (true) {
-          if (state == State::ShouldTerminate) {
-            return;
-          }
+  thread_ = std::thread([this, index = index_,
+                         &get_jobs_callback = get_jobs_callback_,
+                         &run_job_callback = run_job_callback_,
+                         &cpu_set = cpu_set_]() {
+    bind_worker_thread(index, cpu_set);
+    tracing::set_thread_name("Worker " + std::to_string(index));
+
+    auto jobs = std::vector<Job>();
+
+    while (true) {
+      jobs.clear();
+      get_jobs_callback(jobs, jobs.max_size());
+      if (jobs.empty()) {
+        wait_for_stop();
+        return;
+      }
+      for (const auto& job : jobs) {
+        run_job_callback(job, index);
+      }
+    }
+  });
+}
 
-          const auto job_optional = get_job_callback();
-          if (job_optional.has_value()) {
-            const auto& job = job_optional.value();
-            job();
+void GraphGenerationController::Worker::start(
+    int tasks_count,
+    const StartTaskCallback& start_task_callback,
+    const FinishTaskCallback& finish_task_callback) {
+  assert(state_ == State::Idle);
+  assert(tasks_count > 0);
+
+  state_ = State::Working;
+  start_task_callback_ = start_task_callback;
+  finish_task_callback_ = finish_task_callback;
+
+  thread_ = std::thread([this, index = index_, tasks_count,
+                         &get_jobs_callback = get_jobs_callback_,
+                         &start_task_callback = start_task_callback_,
+                         &finish_task_callback = finish_task_callback_,
+                         &cpu_set = cpu_set_]() {
+    bind_worker_thread(index, cpu_set);
+    tracing::set_thread_name("Worker " + std::to_string(index));
+
+    auto jobs = std::vector<Job>();
+    auto tasks = std::deque<std::pair<Job, GraphGenerator::Task>>();
+
+    while (true) {
+      if (tasks.size() < static_cast<std::size_t>(tasks_count)) {
+        jobs.clear();
+        get_jobs_callback(jobs, tasks_count - tasks.size());
+        for (const auto& job : jobs) {
+          auto task_optional = start_task_callback(job);
+          if (task_optional.has_value()) {
+            tasks.emplace_back(job, std::move(task_optional.value()));
           }
         }
-      });
+      }
+
+      if (tasks.empty()) {
+        if (jobs.empty()) {
+          wait_for_stop();
+          return;
+        }
+        continue;
+      }
+
+      auto [job, task] = std::move(tasks.front());
+      tasks.pop_front();
+      auto is_resumed = false;
+      {
+        const tracing::Span span("Task Step", "controller", "graph",
+                                 job.graph_index);
+        is_resumed = task.resume();
+      }
+      if (is_resumed) {
+        tasks.emplace_back(job, std::move(task));
+      } else {
+        finish_task_callback(job, std::move(task), index);
+      }
+    }
+  });
 }
 
 void GraphGenerationController::Worker::stop() {
   assert(state_ == State::Working);
 
-  state_ = State::ShouldTerminate;
+  {
+    const std::lock_guard lock(state_mutex_);
+    state_ = State::ShouldTerminate;
+  }
+  state_changed_.notify_one();
   thread_.join();
   state_ = State::Idle;
 }
 
+void GraphGenerationController::Worker::wait_for_stop() {
+  auto lock = std::unique_lock(state_mutex_);
+  state_changed_.wait(lock,
+                      [this]() { return state_ == State::ShouldTerminate; });
+}
+
+void GraphGenerationController::Worker::set_cpu_set(
+    const std::optional<thread_affinity::CpuSet>& cpu_set) {
+  assert(state_ == State::Idle);
+
+  cpu_set_ = cpu_set;
+}
+
 GraphGenerationController::Worker::~Worker() {
   if (state_ == State::Working) {
     stop();
@@ -47,63 +204,288 @@ GraphGenerationController::GraphGenerationController(
     int threads_count,
     int graphs_count,
     GraphGenerator::Params&& graph_generator_params)
+    : GraphGenerationController(
+          threads_count,
+          make_graphs_generator_params(graphs_count,
+                                       graph_generator_params)) {}
+
+GraphGenerationController::GraphGenerationController(
+    int threads_count,
+    std::vector<GraphGenerator::Params>&& graphs_generator_params)
     : threads_count_(threads_count),
-      graphs_count_(graphs_count),
-      graph_generator_(std::move(graph_generator_params)) {
-  const auto job_optional = [&jobs = jobs_,
-                             &jobs_mutex =
-                                 jobs_mutex_]() -> std::optional<JobCallback> {
-    const std::lock_guard lock(jobs_mutex);
-
-    if (!jobs.empty()) {
-      auto job = jobs.back();
-      jobs.pop_back();
-
-      return job;
+      graphs_count_(graphs_generator_params.size()),
+      statistics_(threads_count) {
+  graph_generators_.reserve(graphs_count_);
+  for (auto& graph_generator_params : graphs_generator_params) {
+    graph_generators_.emplace_back(std::move(graph_generator_params));
+  }
+
+  // Jobs are taken in batches of roughly 1 / (2 * threads_count) of the
+  // remaining cost, so one lock serves several small graphs, while the large
+  // ones at the head are still spread over all workers.
+  const auto get_jobs = [this, share = 2 * threads_count_](
+                            std::vector<Job>& batch, std::size_t max_count) {
+    const auto lock =
+        lock_measured(jobs_mutex_, get_statistics_collector(),
+                      GenerationStatistics::LockKind::JobsMutex);
+
+    if (!jobs_.empty()) {
+      jobs_.pop_batch(batch, share, max_count);
     }
-    return std::nullopt;
   };
 
   for (int i = 0; i < threads_count_; i++) {
-    workers_.emplace_back(job_optional);
+    workers_.emplace_back(i, get_jobs);
   }
 }
 
-void GraphGenerationController::generate(
+void GraphGenerationController::set_graph_timeout(
+    std::chrono::milliseconds graph_timeout) {
+  graph_timeout_ = graph_timeout;
+}
+
+void GraphGenerationController::set_batch_timeout(
+    std::chrono::milliseconds batch_timeout) {
+  batch_timeout_ = batch_timeout;
+}
+
+void GraphGenerationController::set_thread_affinity(
+    thread_affinity::Policy policy) {
+  set_worker_cpu_sets(
+      thread_affinity::make_worker_cpu_sets(threads_count_, policy));
+}
+
+void GraphGenerationController::set_worker_cpu_sets(
+    const std::vector<thread_affinity::CpuSet>& cpu_sets) {
+  int worker_index = 0;
+  for (auto& worker : workers_) {
+    if (cpu_sets.empty()) {
+      worker.set_cpu_set(std::nullopt);
+    } else {
+      worker.set_cpu_set(cpu_sets[worker_index % cpu_sets.size()]);
+    }
+    worker_index++;
+  }
+}
+
+void GraphGenerationController::set_cooperative_scheduling(
+    int tasks_per_worker) {
+  tasks_per_worker_ = tasks_per_worker;
+}
+
+void GraphGenerationController::set_statistics_enabled(bool is_enabled) {
+  is_statistics_enabled_ = is_enabled;
+}
+
+GenerationStatistics::Snapshot GraphGenerationController::get_statistics()
+    const {
+  return statistics_.get_snapshot();
+}
+
+void GraphGenerationController::set_deduplication_enabled(bool is_enabled) {
+  is_deduplication_enabled_ = is_enabled;
+}
+
+int GraphGenerationController::get_unique_graphs_count() const {
+  return unique_graphs_count_;
+}
+
+GenerationStatistics* GraphGenerationController::get_statistics_collector() {
+  return is_statistics_enabled_ ? &statistics_ : nullptr;
+}
+
+void GraphGenerationController::cancel() {
+  const std::lock_guard lock(cancellation_mutex_);
+  cancellation_token_.cancel();
+}
+
+GenerationStatus GraphGenerationController::generate(
     const GenStartedCallback& gen_started_callback,
     const GenFinishedCallback& gen_finished_callback) {
   std::mutex callback_mutex;
+  // Guarded by callback_mutex
+  // Forms of the unique graphs by their hashes, a hash may be shared by
+  // graphs which aren't isomorphic
+  std::unordered_map<std::uint64_t, std::vector<CanonicalForm>>
+      canonical_forms;
+  unique_graphs_count_ = 0;
+
+  const auto batch_token = [this]() {
+    const std::lock_guard lock(cancellation_mutex_);
+    cancellation_token_ = CancellationToken();
+    return batch_timeout_.has_value()
+               ? cancellation_token_.with_timeout(batch_timeout_.value())
+               : cancellation_token_.make_child();
+  }();
+  std::atomic<GenerationStatus> batch_status = GenerationStatus::Completed;
+
+  statistics_.reset();
+  auto* const statistics = get_statistics_collector();
+  const auto batch_start_time = std::chrono::steady_clock::now();
 
   std::atomic<int> current_jobs_count = graphs_count_;
-  for (int i = 0; i < graphs_count_; i++) {
-    jobs_.emplace_back([i, &gen_started_callback, &gen_finished_callback,
-                        &current_jobs_count, &callback_mutex,
-                        &graph_generator = graph_generator_]() {
-      {
-        const std::lock_guard lock(callback_mutex);
-        gen_started_callback(i);
-      }
+  std::mutex jobs_finished_mutex;
+  std::condition_variable jobs_finished;
+  const auto count_finished_job = [&current_jobs_count, &jobs_finished_mutex,
+                                   &jobs_finished]() {
+    if (--current_jobs_count == 0) {
+      const std::lock_guard lock(jobs_finished_mutex);
+      jobs_finished.notify_one();
+    }
+  };
 
-      auto graph = graph_generator.generate();
+  // Returns the graph token, or nothing if the job is skipped
+  const auto start_job =
+      [&gen_started_callback, &count_finished_job, &callback_mutex,
+       &batch_token, &batch_status, &graph_timeout = graph_timeout_,
+       statistics, batch_start_time](
+          const Job& job) -> std::optional<CancellationToken> {
+    if (batch_token.is_stopped()) {
+      batch_status = batch_token.status();
+      count_finished_job();
+      return std::nullopt;
+    }
 
-      {
-        const std::lock_guard lock(callback_mutex);
-        gen_finished_callback(i, std::move(graph));
-      }
+    if (statistics != nullptr) {
+      statistics->add_queue_wait_time(
+          std::chrono::duration_cast<GenerationStatistics::Duration>(
+              std::chrono::steady_clock::now() - batch_start_time));
+    }
 
-      current_jobs_count--;
-    });
+    {
+      const std::lock_guard lock(callback_mutex);
+      gen_started_callback(job.graph_index);
+    }
+
+    return graph_timeout.has_value()
+               ? batch_token.with_timeout(graph_timeout.value())
+               : batch_token.make_child();
+  };
+
+  const auto finish_job =
+      [&gen_finished_callback, &count_finished_job, &callback_mutex,
+       &batch_status, &canonical_forms,
+       &unique_graphs_count = unique_graphs_count_,
+       is_deduplication_enabled = is_deduplication_enabled_,
+       statistics](const Job& job, Graph&& graph, GenerationStatus status,
+                   int worker_index) {
+        if (status != GenerationStatus::Completed) {
+          batch_status = status;
+        }
+
+        if (statistics != nullptr) {
+          statistics->add_finished_job(worker_index, graph);
+        }
+
+        // Hashed before locking, so workers don't wait for each other. The
+        // form is needed whether the hash is new or not, a new one keeps
+        // the form for the graphs sharing the hash later.
+        auto graph_hash = std::optional<std::uint64_t>();
+        auto canonical_form = std::optional<CanonicalForm>();
+        if (is_deduplication_enabled) {
+          const auto hashes = get_structural_hashes(graph);
+          graph_hash = hashes.graph_hash;
+          canonical_form = get_canonical_form(graph, hashes);
+        }
+
+        Logger::log<LogLevel::Debug>([&job, worker_index]() {
+          return "Worker " + std::to_string(worker_index) + ", Graph " +
+                 std::to_string(job.graph_index) + ", Job Finished";
+        });
+
+        {
+          const tracing::Span span("Finish Callback", "controller", "graph",
+                                   job.graph_index);
+          const std::lock_guard lock(callback_mutex);
+          bool is_duplicate = false;
+          if (graph_hash.has_value()) {
+            // Equal hashes only suggest a duplicate, the forms prove it
+            auto& forms = canonical_forms[graph_hash.value()];
+            is_duplicate =
+                std::find(forms.begin(), forms.end(),
+                          canonical_form.value()) != forms.end();
+            if (!is_duplicate) {
+              forms.push_back(std::move(canonical_form.value()));
+            }
+          }
+
+          if (is_duplicate) {
+            Logger::log<LogLevel::Debug>([&job]() {
+              return "Graph " + std::to_string(job.graph_index) +
+                     ", Duplicate Found";
+            });
+          } else {
+            unique_graphs_count++;
+          }
+          gen_finished_callback(job.graph_index, std::move(graph), status,
+                                is_duplicate);
+        }
+
+        count_finished_job();
+      };
+
+  const auto run_job = [&start_job, &finish_job,
+                        &graph_generators = graph_generators_,
+                        statistics](const Job& job, int worker_index) {
+    const tracing::Span span("Graph", "controller", "graph", job.graph_index);
+    const auto graph_token = start_job(job);
+    if (graph_token.has_value()) {
+      auto graph = graph_generators[job.graph_index].generate(*graph_token,
+                                                              statistics);
+      finish_job(job, std::move(graph), graph_token->status(), worker_index);
+    }
+  };
+
+  const auto start_task = [&start_job, &graph_generators = graph_generators_,
+                           statistics](const Job& job)
+      -> std::optional<GraphGenerator::Task> {
+    const auto graph_token = start_job(job);
+    if (!graph_token.has_value()) {
+      return std::nullopt;
+    }
+    return graph_generators[job.graph_index].make_task(*graph_token,
+                                                       statistics);
+  };
+
+  const auto finish_task = [&finish_job](const Job& job,
+                                         GraphGenerator::Task&& task,
+                                         int worker_index) {
+    finish_job(job, task.take_graph(), task.token().status(), worker_index);
+  };
+
+  {
+    auto jobs = std::vector<Job>();
+    jobs.reserve(graphs_count_);
+    for (int i = 0; i < graphs_count_; i++) {
+      jobs.push_back({i, graph_generators_[i].estimate_vertices_count()});
+    }
+
+    const std::lock_guard lock(jobs_mutex_);
+    jobs_.reset(std::move(jobs));
   }
 
   for (auto& worker : workers_) {
-    worker.start();
+    if (tasks_per_worker_ > 0) {
+      worker.start(tasks_per_worker_, start_task, finish_task);
+    } else {
+      worker.start(run_job);
+    }
   }
 
-  while (current_jobs_count > 0) {
+  {
+    auto lock = std::unique_lock(jobs_finished_mutex);
+    jobs_finished.wait(
+        lock, [&current_jobs_count]() { return current_jobs_count == 0; });
   }
 
   for (auto& worker : workers_) {
     worker.stop();
   }
+
+  statistics_.set_batch_time(
+      std::chrono::duration_cast<GenerationStatistics::Duration>(
+          std::chrono::steady_clock::now() - batch_start_time));
+
+  return batch_status;
 }
 }  // namespace uni_course_cpp
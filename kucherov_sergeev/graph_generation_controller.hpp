@@ -1,54 +1,167 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <list>
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <vector>
 
+#include "cancellation_token.hpp"
+#include "generation_statistics.hpp"
 #include "graph.hpp"
 #include "graph_generator.hpp"
+#include "thread_affinity.hpp"
 
 namespace uni_course_cpp {
 class GraphGenerationController {
  public:
   using GenStartedCallback = std::function<void(int index)>;
-  using GenFinishedCallback = std::function<void(int index, Graph&& graph)>;
+  // Both callbacks are called on the worker which generates the graph, one
+  // at a time, so they should hand the graph over rather than serialize it.
+  // is_duplicate is only ever true with deduplication enabled
+  using GenFinishedCallback = std::function<void(int index,
+                                                 Graph&& graph,
+                                                 GenerationStatus status,
+                                                 bool is_duplicate)>;
 
+  // With a seed in the params graph i is generated with the seed + i
   GraphGenerationController(int threads_count,
                             int graphs_count,
                             GraphGenerator::Params&& graph_generator_params);
 
-  void generate(const GenStartedCallback& gen_started_callback,
-                const GenFinishedCallback& gen_finished_callback);
+  // Generates one graph per params, the largest estimated graphs first.
+  GraphGenerationController(
+      int threads_count,
+      std::vector<GraphGenerator::Params>&& graphs_generator_params);
+
+  void set_graph_timeout(std::chrono::milliseconds graph_timeout);
+  void set_batch_timeout(std::chrono::milliseconds batch_timeout);
+
+  // Worker threads and the threads started by the generator are pinned,
+  // so the graph memory stays local to the worker's NUMA node.
+  void set_thread_affinity(thread_affinity::Policy policy);
+  void set_worker_cpu_sets(
+      const std::vector<thread_affinity::CpuSet>& cpu_sets);
+
+  // Instead of generating one graph at a time with the generator's own
+  // threads, every worker keeps up to tasks_per_worker graphs in progress
+  // and resumes them round-robin, one generation step at a time. Suits
+  // batches of many small graphs. Zero turns it off.
+  void set_cooperative_scheduling(int tasks_per_worker);
+
+  // Phase times, lock and queue waits, throughput and jobs per worker of
+  // the last batch. Collecting them costs two clock reads per lock.
+  void set_statistics_enabled(bool is_enabled);
+  GenerationStatistics::Snapshot get_statistics() const;
+
+  // Graphs isomorphic to a graph already finished in the batch are passed
+  // to gen_finished_callback as duplicates, so the caller may skip writing
+  // them. Graphs with equal structural hashes are compared by their
+  // canonical forms, so a hash collision never marks a graph as a
+  // duplicate. Costs a hash and a canonical form of every graph.
+  void set_deduplication_enabled(bool is_enabled);
+  // Graphs of the last batch which weren't duplicates
+  int get_unique_graphs_count() const;
+
+  // Graphs which haven't been started yet are skipped, the ones in progress
+  // are finished with the truncated graph. Safe to call from any thread.
+  // Only the batch in progress is cancelled, every generate() call starts
+  // with a fresh token.
+  void cancel();
+
+  GenerationStatus generate(const GenStartedCallback& gen_started_callback,
+                            const GenFinishedCallback& gen_finished_callback);
 
  private:
-  using JobCallback = std::function<void()>;
+  struct Job {
+    int graph_index = 0;
+    double estimated_cost = 0;
+  };
+
+  // Contiguous queue of jobs in the order of decreasing cost, so the largest
+  // graphs are started first. Not thread-safe, guarded by jobs_mutex_.
+  class JobQueue {
+   public:
+    void reset(std::vector<Job>&& jobs);
+
+    // Takes jobs from the head until their cost reaches the given share of
+    // the remaining cost, but at least one job and at most max_jobs_count.
+    void pop_batch(std::vector<Job>& batch,
+                   int share,
+                   std::size_t max_jobs_count);
+
+    bool empty() const { return size_ == 0; }
+
+   private:
+    std::vector<Job> ring_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    double remaining_cost_ = 0;
+  };
 
   class Worker {
    public:
-    using GetJobCallback = std::function<std::optional<JobCallback>()>;
+    using GetJobsCallback =
+        std::function<void(std::vector<Job>& jobs, std::size_t max_count)>;
+    using RunJobCallback =
+        std::function<void(const Job& job, int worker_index)>;
+    using StartTaskCallback =
+        std::function<std::optional<GraphGenerator::Task>(const Job& job)>;
+    using FinishTaskCallback = std::function<
+        void(const Job& job, GraphGenerator::Task&& task, int worker_index)>;
 
-    explicit Worker(const GetJobCallback& get_job_callback)
-        : get_job_callback_(get_job_callback){};
+    Worker(int index, const GetJobsCallback& get_jobs_callback)
+        : index_(index), get_jobs_callback_(get_jobs_callback){};
 
     ~Worker();
-    void start();
+    void start(const RunJobCallback& run_job_callback);
+    void start(int tasks_count,
+               const StartTaskCallback& start_task_callback,
+               const FinishTaskCallback& finish_task_callback);
     void stop();
 
+    void set_cpu_set(const std::optional<thread_affinity::CpuSet>& cpu_set);
+
    private:
     enum class State { Idle, Working, ShouldTerminate };
 
+    // Jobs are never added during a batch, so once the queue is drained
+    // the worker sleeps here until the batch is over
+    void wait_for_stop();
+
+    int index_;
     std::thread thread_;
-    GetJobCallback get_job_callback_;
+    GetJobsCallback get_jobs_callback_;
+    RunJobCallback run_job_callback_;
+    StartTaskCallback start_task_callback_;
+    FinishTaskCallback finish_task_callback_;
+    std::optional<thread_affinity::CpuSet> cpu_set_;
+    // Written by the controller, read by the worker thread under the mutex
+    std::mutex state_mutex_;
+    std::condition_variable state_changed_;
     State state_ = State::Idle;
   };
 
+  GenerationStatistics* get_statistics_collector();
+
   std::list<Worker> workers_;
-  std::list<JobCallback> jobs_;
+  JobQueue jobs_;
   int threads_count_;
   int graphs_count_;
-  GraphGenerator graph_generator_;
+  std::vector<GraphGenerator> graph_generators_;
   std::mutex jobs_mutex_;
+  // Replaced by every batch, the mutex guards the replacement from cancel()
+  std::mutex cancellation_mutex_;
+  CancellationToken cancellation_token_;
+  std::optional<std::chrono::milliseconds> graph_timeout_;
+  std::optional<std::chrono::milliseconds> batch_timeout_;
+  int tasks_per_worker_ = 0;
+  GenerationStatistics statistics_;
+  bool is_statistics_enabled_ = false;
+  bool is_deduplication_enabled_ = false;
+  int unique_graphs_count_ = 0;
 };
 }  // namespace uni_course_cpp
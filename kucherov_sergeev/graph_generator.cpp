@@ -1,14 +1,19 @@
 #include <algorithm>
-#include <atomic>
 #include <cassert>
-#include <functional>
-#include <list>
+#include <mutex>
 #include <optional>
 #include <random>
 #include <thread>
+#include <utility>
+#include <vector>
 
+#include "cancellation_token.hpp"
+#include "generation_statistics.hpp"
 #include "graph.hpp"
 #include "graph_generator.hpp"
+#include "logger.hpp"
+#include "perf_counters.hpp"
+#include "tracing.hpp"
 
 namespace uni_course_cpp {
 namespace {
@@ -18,17 +23,40 @@ static constexpr float kEdgeRedProbability = 0.33;
 static constexpr Graph::Depth kYellowEdgeLength = 1;
 static constexpr Graph::Depth kRedEdgeLength = 2;
 
-bool get_random_bool(float true_probability) {
-  std::random_device random_device;
-  std::mt19937 generator(random_device());
+using Seed = GraphGenerator::Seed;
+using RandomEngine = GraphGenerator::RandomEngine;
+// The colored phases only read the graph, so they run concurrently and
+// their edges are added afterwards in a fixed order
+using NewEdges = std::vector<std::pair<Graph::VertexId, Graph::VertexId>>;
+
+Seed get_seed(const GraphGenerator::Params& params) {
+  return params.seed().value_or(std::random_device()());
+}
+
+// Every phase, and every grey branch of the root, draws from its own
+// engine, so the threads don't share one and the graph doesn't depend on
+// their scheduling
+RandomEngine make_random_engine(Seed seed,
+                                GenerationPhase phase,
+                                int stream_index = 0) {
+  std::seed_seq seed_sequence = {seed, static_cast<Seed>(phase),
+                                 static_cast<Seed>(stream_index)};
+  return RandomEngine(seed_sequence);
+}
+
+float get_new_vertex_probability(Graph::Depth depth,
+                                 Graph::Depth current_depth) {
+  return 1.f - (current_depth - 1.f) / (depth - 1.f);
+}
+
+bool get_random_bool(RandomEngine& random_engine, float true_probability) {
   std::bernoulli_distribution bernoulli_distribution(true_probability);
-  return bernoulli_distribution(generator);
+  return bernoulli_distribution(random_engine);
 }
 
-std::vector<Graph::VertexId> get_unconnected_vertex_ids(
-    const Graph& graph,
-    Graph::VertexId vertex_id) {
-  std::vector<Graph::VertexId> unconnected_vertex_ids = {};
+Graph::VertexIds get_unconnected_vertex_ids(const Graph& graph,
+                                            Graph::VertexId vertex_id) {
+  Graph::VertexIds unconnected_vertex_ids = {};
   for (const auto next_depth_vertex_id :
        graph.get_depth_vertex_ids(graph.get_vertex_depth(vertex_id) + 1)) {
     if (!graph.is_vertices_connected(vertex_id, next_depth_vertex_id)) {
@@ -39,42 +67,206 @@ std::vector<Graph::VertexId> get_unconnected_vertex_ids(
   return unconnected_vertex_ids;
 }
 
-Graph::VertexId get_random_vertex_id(
-    const std::vector<Graph::VertexId>& vertex_ids) {
+Graph::VertexId get_random_vertex_id(RandomEngine& random_engine,
+                                     const Graph::VertexIds& vertex_ids) {
   assert((!vertex_ids.empty()) &&
          "Can't pick random vertex id from empty list");
 
-  std::random_device random_device;
-  std::mt19937 generator(random_device());
   std::uniform_int_distribution<> uniform_int_distribution(
       0, vertex_ids.size() - 1);
 
-  return vertex_ids[uniform_int_distribution(generator)];
+  return vertex_ids[uniform_int_distribution(random_engine)];
+}
+
+// A graph of the default depth is only the root
+bool has_grey_branches(const GraphGenerator::Params& params) {
+  return params.depth() > kGraphDefaultDepth && params.new_vertices_count() > 0;
+}
+
+// Vertices of a grey branch of the root in the order they are added, by
+// the index of their parent in the branch. The first one is the child of
+// the root, its parent index is kRootParentIndex.
+using GreyBranch = std::vector<int>;
+static constexpr int kRootParentIndex = -1;
+
+void generate_grey_branch(const GraphGenerator::Params& params,
+                          int parent_index,
+                          Graph::Depth current_depth,
+                          RandomEngine& random_engine,
+                          const CancellationToken& token,
+                          GreyBranch& branch) {
+  if (token.is_stopped()) {
+    return;
+  }
+
+  const float new_vertex_probability =
+      get_new_vertex_probability(params.depth(), current_depth);
+
+  if (!get_random_bool(random_engine, new_vertex_probability)) {
+    return;
+  }
+
+  const int vertex_index = branch.size();
+  branch.push_back(parent_index);
+
+  for (int attempt = 0; attempt < params.new_vertices_count(); attempt++) {
+    if (current_depth < params.depth()) {
+      generate_grey_branch(params, vertex_index, current_depth + 1,
+                           random_engine, token, branch);
+    }
+  }
+}
+
+// Branches only depend on the seed and their index, so they may be grown
+// in any order and on any thread
+GreyBranch generate_grey_branch(const GraphGenerator::Params& params,
+                                Seed seed,
+                                int branch_index,
+                                const CancellationToken& token) {
+  const tracing::Span span("Grey Branch", "generator");
+  auto random_engine =
+      make_random_engine(seed, GenerationPhase::Grey, branch_index);
+  auto branch = GreyBranch();
+  generate_grey_branch(params, kRootParentIndex, kGraphDefaultDepth,
+                       random_engine, token, branch);
+  return branch;
+}
+
+// Branches are added in the order of their indices, so the vertex ids
+// don't depend on which branch was grown first
+void add_grey_branch(Graph& graph,
+                     Graph::VertexId root_id,
+                     const GreyBranch& branch) {
+  auto vertex_ids = std::vector<Graph::VertexId>();
+  vertex_ids.reserve(branch.size());
+  for (const auto parent_index : branch) {
+    vertex_ids.push_back(graph.add_vertex());
+    graph.add_edge(
+        parent_index == kRootParentIndex ? root_id : vertex_ids[parent_index],
+        vertex_ids.back());
+  }
+}
+
+void generate_grey_edges(Graph& graph,
+                         Graph::VertexId root_id,
+                         const GraphGenerator::Params& params,
+                         Seed seed,
+                         const CancellationToken& token,
+                         GenerationStatistics* statistics) {
+  const GenerationStatistics::PhaseTimer phase_timer(statistics,
+                                                     GenerationPhase::Grey);
+  const tracing::Span span("Grey Edges", "generator");
+  const int branches_count = params.new_vertices_count();
+  auto branches = std::vector<GreyBranch>(branches_count);
+  std::mutex jobs_mutex;
+  int next_branch_index = 0;
+
+  // Branches don't add jobs, so a thread is done once they are all taken
+  const auto worker = [&params, seed, &token, statistics, &branches,
+                       &jobs_mutex, &next_branch_index, branches_count]() {
+    tracing::set_thread_name("Grey Edges");
+    const auto start_cpu_time = get_thread_cpu_time();
+    const perf::Scope counters_scope(
+        statistics != nullptr
+            ? &statistics->get_phase_counters(GenerationPhase::Grey)
+            : nullptr);
+
+    while (true) {
+      const auto branch_index = [&jobs_mutex, &next_branch_index,
+                                 statistics]() {
+        const auto lock =
+            lock_measured(jobs_mutex, statistics,
+                          GenerationStatistics::LockKind::GreyJobsMutex);
+        return next_branch_index++;
+      }();
+
+      if (branch_index >= branches_count) {
+        if (statistics != nullptr) {
+          statistics->add_phase_time(
+              GenerationPhase::Grey, GenerationStatistics::Duration::zero(),
+              get_thread_cpu_time() - start_cpu_time);
+        }
+        return;
+      }
+
+      branches[branch_index] =
+          generate_grey_branch(params, seed, branch_index, token);
+    }
+  };
+
+  const auto threads_count = std::min(kMaxThreadsCount, branches_count);
+  auto threads = std::vector<std::thread>();
+  threads.reserve(threads_count);
+
+  for (int i = 0; i < threads_count; i++) {
+    threads.emplace_back(worker);
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& branch : branches) {
+    add_grey_branch(graph, root_id, branch);
+  }
+}
+
+void add_edges(Graph& graph,
+               const NewEdges& edges,
+               GenerationPhase phase,
+               GenerationStatistics* statistics) {
+  const GenerationStatistics::PhaseTimer phase_timer(statistics, phase);
+  for (const auto& [from_vertex_id, to_vertex_id] : edges) {
+    graph.add_edge(from_vertex_id, to_vertex_id);
+  }
 }
 
-void generate_green_edges(Graph& graph, std::mutex& graph_mutex) {
+NewEdges generate_green_edges(const Graph& graph,
+                              Seed seed,
+                              const CancellationToken& token,
+                              GenerationStatistics* statistics) {
+  const GenerationStatistics::PhaseTimer phase_timer(statistics,
+                                                     GenerationPhase::Green);
+  const tracing::Span span("Green Edges", "generator");
+  auto random_engine = make_random_engine(seed, GenerationPhase::Green);
+  auto edges = NewEdges();
   for (Graph::Depth current_depth = kGraphDefaultDepth;
-       current_depth <= graph.get_depth(); current_depth++) {
+       current_depth <= graph.get_depth() && !token.is_stopped();
+       current_depth++) {
     const auto& current_depth_vertex_ids =
         graph.get_depth_vertex_ids(current_depth);
     if (!current_depth_vertex_ids.empty()) {
       std::for_each(current_depth_vertex_ids.begin(),
                     current_depth_vertex_ids.end(),
-                    [&graph, &graph_mutex](Graph::VertexId vertex_id) {
-                      if (get_random_bool(kEdgeGreenProbability)) {
-                        const std::lock_guard lock(graph_mutex);
-                        graph.add_edge(vertex_id, vertex_id);
+                    [&edges, &random_engine,
+                     &token](Graph::VertexId vertex_id) {
+                      if (token.is_stopped()) {
+                        return;
+                      }
+                      if (get_random_bool(random_engine,
+                                          kEdgeGreenProbability)) {
+                        edges.emplace_back(vertex_id, vertex_id);
                       }
                     });
     }
   }
+  return edges;
 }
 
-void generate_yellow_edges(Graph& graph, std::mutex& graph_mutex) {
+NewEdges generate_yellow_edges(const Graph& graph,
+                               Seed seed,
+                               const CancellationToken& token,
+                               GenerationStatistics* statistics) {
+  const GenerationStatistics::PhaseTimer phase_timer(statistics,
+                                                     GenerationPhase::Yellow);
+  const tracing::Span span("Yellow Edges", "generator");
+  auto random_engine = make_random_engine(seed, GenerationPhase::Yellow);
+  auto edges = NewEdges();
   const auto graph_depth = graph.get_depth();
 
   for (Graph::Depth current_depth = kGraphDefaultDepth;
-       current_depth <= graph_depth - kYellowEdgeLength; current_depth++) {
+       current_depth <= graph_depth - kYellowEdgeLength && !token.is_stopped();
+       current_depth++) {
     float new_edge_probability = current_depth / (graph_depth - 1.f);
 
     const auto& current_depth_vertex_ids =
@@ -83,28 +275,42 @@ void generate_yellow_edges(Graph& graph, std::mutex& graph_mutex) {
     if (!current_depth_vertex_ids.empty()) {
       std::for_each(
           current_depth_vertex_ids.begin(), current_depth_vertex_ids.end(),
-          [&graph, &graph_mutex,
+          [&graph, &edges, &random_engine, &token,
            new_edge_probability](Graph::VertexId vertex_id) {
-            if (get_random_bool(new_edge_probability)) {
-              const std::lock_guard lock(graph_mutex);
+            if (token.is_stopped()) {
+              return;
+            }
+            // Only grey edges join the vertex to the next depth, the other
+            // phases don't add such edges, so the graph needn't be updated
+            if (get_random_bool(random_engine, new_edge_probability)) {
               const auto& to_vertex_ids =
                   get_unconnected_vertex_ids(graph, vertex_id);
 
               if (to_vertex_ids.empty() == false) {
-                const auto to_vertex_id = get_random_vertex_id(to_vertex_ids);
+                const auto to_vertex_id =
+                    get_random_vertex_id(random_engine, to_vertex_ids);
 
-                graph.add_edge(vertex_id, to_vertex_id);
+                edges.emplace_back(vertex_id, to_vertex_id);
               }
             }
           });
     }
   }
+  return edges;
 }
 
-void generate_red_edges(Graph& graph, std::mutex& graph_mutex) {
+NewEdges generate_red_edges(const Graph& graph,
+                            Seed seed,
+                            const CancellationToken& token,
+                            GenerationStatistics* statistics) {
+  const GenerationStatistics::PhaseTimer phase_timer(statistics,
+                                                     GenerationPhase::Red);
+  const tracing::Span span("Red Edges", "generator");
+  auto random_engine = make_random_engine(seed, GenerationPhase::Red);
+  auto edges = NewEdges();
   const auto max_depth = graph.get_depth() - kRedEdgeLength;
   for (Graph::Depth current_depth = kGraphDefaultDepth;
-       current_depth <= max_depth; current_depth++) {
+       current_depth <= max_depth && !token.is_stopped(); current_depth++) {
     const auto& to_vertex_ids =
         graph.get_depth_vertex_ids(current_depth + kRedEdgeLength);
 
@@ -117,130 +323,164 @@ void generate_red_edges(Graph& graph, std::mutex& graph_mutex) {
     if (!current_depth_vertex_ids.empty()) {
       std::for_each(
           current_depth_vertex_ids.begin(), current_depth_vertex_ids.end(),
-          [&graph, &graph_mutex, &to_vertex_ids](Graph::VertexId vertex_id) {
-            if (get_random_bool(kEdgeRedProbability)) {
-              const auto to_vertex_id = get_random_vertex_id(to_vertex_ids);
-              const std::lock_guard lock(graph_mutex);
-              graph.add_edge(vertex_id, to_vertex_id);
+          [&edges, &random_engine, &to_vertex_ids,
+           &token](Graph::VertexId vertex_id) {
+            if (token.is_stopped()) {
+              return;
+            }
+            if (get_random_bool(random_engine, kEdgeRedProbability)) {
+              const auto to_vertex_id =
+                  get_random_vertex_id(random_engine, to_vertex_ids);
+              edges.emplace_back(vertex_id, to_vertex_id);
             }
           });
     }
   }
+  return edges;
 }
 }  // namespace
 
-void GraphGenerator::generate_grey_branch(Graph& graph,
-                                          Graph::VertexId root_vertex_id,
-                                          Graph::Depth current_depth,
-                                          std::mutex& graph_mutex) const {
-  const float new_vertex_probability =
-      1.f - (current_depth - 1.f) / (params_.depth() - 1.f);
-
-  if (!get_random_bool(new_vertex_probability)) {
-    return;
-  }
-
-  const auto new_vertex_id = [&graph_mutex, &graph, root_vertex_id]() {
-    const std::lock_guard lock(graph_mutex);
-    const auto new_vertex_id = graph.add_vertex();
-    graph.add_edge(root_vertex_id, new_vertex_id);
-    return new_vertex_id;
-  }();
-
-  for (int attempt = 0; attempt < params_.new_vertices_count(); attempt++) {
-    if (current_depth < params_.depth()) {
-      generate_grey_branch(graph, new_vertex_id, current_depth + 1,
-                           graph_mutex);
-    }
-  }
+Graph GraphGenerator::generate() const {
+  return generate(CancellationToken());
 }
 
-Graph GraphGenerator::generate() const {
+Graph GraphGenerator::generate(const CancellationToken& token,
+                               GenerationStatistics* statistics) const {
   auto graph = Graph();
 
   if (params_.depth() != 0) {
+    const auto seed = get_seed(params_);
     const auto root_id = graph.add_vertex();
-    generate_grey_edges(graph, root_id);
-
-    std::mutex graph_mutex;
-
-    auto greed_edges_thread = std::thread(
-        [&graph, &graph_mutex]() { generate_green_edges(graph, graph_mutex); });
-
-    auto yellow_edges_thread = std::thread([&graph, &graph_mutex]() {
-      generate_yellow_edges(graph, graph_mutex);
+    if (has_grey_branches(params_)) {
+      generate_grey_edges(graph, root_id, params_, seed, token, statistics);
+    }
+    Logger::log<LogLevel::Trace>([&graph]() {
+      return "Grey Edges Generated, vertices: " +
+             std::to_string(graph.get_vertices().size());
     });
 
-    auto red_edges_thread = std::thread(
-        [&graph, &graph_mutex]() { generate_red_edges(graph, graph_mutex); });
+    auto green_edges = NewEdges();
+    auto greed_edges_thread = std::thread(
+        [&graph, &green_edges, seed, &token, statistics]() {
+          tracing::set_thread_name("Green Edges");
+          green_edges = generate_green_edges(graph, seed, token, statistics);
+        });
+
+    auto yellow_edges = NewEdges();
+    auto yellow_edges_thread = std::thread(
+        [&graph, &yellow_edges, seed, &token, statistics]() {
+          tracing::set_thread_name("Yellow Edges");
+          yellow_edges = generate_yellow_edges(graph, seed, token, statistics);
+        });
+
+    auto red_edges = NewEdges();
+    auto red_edges_thread =
+        std::thread([&graph, &red_edges, seed, &token, statistics]() {
+          tracing::set_thread_name("Red Edges");
+          red_edges = generate_red_edges(graph, seed, token, statistics);
+        });
 
     greed_edges_thread.join();
     yellow_edges_thread.join();
     red_edges_thread.join();
+    add_edges(graph, green_edges, GenerationPhase::Green, statistics);
+    add_edges(graph, yellow_edges, GenerationPhase::Yellow, statistics);
+    add_edges(graph, red_edges, GenerationPhase::Red, statistics);
+    Logger::log<LogLevel::Trace>([&graph]() {
+      return "Colored Edges Generated, edges: " +
+             std::to_string(graph.get_edges().size());
+    });
   }
 
   return graph;
 }
 
-void GraphGenerator::generate_grey_edges(Graph& graph,
-                                         Graph::VertexId root_id) const {
-  std::mutex jobs_mutex, graph_mutex;
-
-  using JobCallback = std::function<void()>;
-  auto jobs = std::list<JobCallback>();
+GraphGenerator::Task::Task(const Params& params,
+                           const CancellationToken& token,
+                           GenerationStatistics* statistics)
+    : params_(params),
+      seed_(get_seed(params)),
+      token_(token),
+      statistics_(statistics) {
+  if (params_.depth() != 0) {
+    root_id_ = graph_.add_vertex();
+    phase_ = has_grey_branches(params_) ? Phase::Grey : Phase::Green;
+  }
+}
 
-  for (int i = 0; i < params_.new_vertices_count(); i++) {
-    jobs.push_back([&graph, root_id, &graph_mutex, this]() {
-      generate_grey_branch(graph, root_id, graph.get_vertex_depth(root_id),
-                           graph_mutex);
-    });
+bool GraphGenerator::Task::resume() {
+  if (phase_ == Phase::Done) {
+    return false;
   }
 
-  std::atomic<bool> should_terminate = false;
-  std::atomic<int> jobs_count = jobs.size();
+  if (token_.is_stopped()) {
+    phase_ = Phase::Done;
+    return false;
+  }
 
-  const auto worker = [&should_terminate, &jobs_mutex, &jobs_count, &jobs]() {
-    while (true) {
-      if (should_terminate) {
-        return;
+  switch (phase_) {
+    case Phase::Grey:
+      grow_grey_branch();
+      if (next_branch_index_ >= params_.new_vertices_count()) {
+        phase_ = Phase::Green;
       }
+      break;
+    case Phase::Green:
+      add_edges(graph_,
+                generate_green_edges(graph_, seed_, token_, statistics_),
+                GenerationPhase::Green, statistics_);
+      phase_ = Phase::Yellow;
+      break;
+    case Phase::Yellow:
+      add_edges(graph_,
+                generate_yellow_edges(graph_, seed_, token_, statistics_),
+                GenerationPhase::Yellow, statistics_);
+      phase_ = Phase::Red;
+      break;
+    case Phase::Red:
+      add_edges(graph_,
+                generate_red_edges(graph_, seed_, token_, statistics_),
+                GenerationPhase::Red, statistics_);
+      phase_ = Phase::Done;
+      break;
+    case Phase::Done:
+      break;
+  }
 
-      const auto job_optional = [&jobs, &jobs_count,
-                                 &jobs_mutex]() -> std::optional<JobCallback> {
-        const std::lock_guard lock(jobs_mutex);
-
-        if (!jobs.empty()) {
-          auto job = jobs.back();
-          jobs.pop_back();
-          jobs_count = jobs.size();
-          return job;
-        }
-        return std::nullopt;
-      }();
+  return phase_ != Phase::Done;
+}
 
-      const std::lock_guard lock(jobs_mutex);
-      if (job_optional.has_value()) {
-        const auto& job = job_optional.value();
-        job();
-      }
-    }
-  };
+void GraphGenerator::Task::grow_grey_branch() {
+  const GenerationStatistics::PhaseTimer phase_timer(statistics_,
+                                                     GenerationPhase::Grey);
+  add_grey_branch(
+      graph_, root_id_,
+      generate_grey_branch(params_, seed_, next_branch_index_, token_));
+  next_branch_index_++;
+}
 
-  const auto threads_count =
-      std::min(kMaxThreadsCount, params_.new_vertices_count());
-  auto threads = std::vector<std::thread>();
-  threads.reserve(threads_count);
+GraphGenerator::Task GraphGenerator::make_task(
+    const CancellationToken& token,
+    GenerationStatistics* statistics) const {
+  return Task(params_, token, statistics);
+}
 
-  for (int i = 0; i < threads_count; i++) {
-    threads.emplace_back(worker);
+double GraphGenerator::estimate_vertices_count() const {
+  if (params_.depth() == 0) {
+    return 0;
   }
 
-  while (jobs_count > 0) {
+  double vertices_count = 1;
+  double depth_vertices_count = 1;
+  for (Graph::Depth current_depth = kGraphDefaultDepth;
+       current_depth < params_.depth(); current_depth++) {
+    const float new_vertex_probability =
+        get_new_vertex_probability(params_.depth(), current_depth);
+    depth_vertices_count *=
+        params_.new_vertices_count() * new_vertex_probability;
+    vertices_count += depth_vertices_count;
   }
 
-  should_terminate = true;
-  for (auto& thread : threads) {
-    thread.join();
-  }
+  return vertices_count;
 }
 }  // namespace uni_course_cpp
@@ -1,35 +1,88 @@
 #pragma once
 
-#include <mutex>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include "cancellation_token.hpp"
+#include "generation_statistics.hpp"
 #include "graph.hpp"
 
 namespace uni_course_cpp {
 class GraphGenerator {
  public:
+  using Seed = std::uint32_t;
+  using RandomEngine = std::mt19937;
+
   struct Params {
    public:
-    Params(Graph::Depth depth, int new_vertices_count)
-        : depth_(depth), new_vertices_count_(new_vertices_count) {}
+    // Without a seed every generation draws one from std::random_device
+    Params(Graph::Depth depth,
+           int new_vertices_count,
+           std::optional<Seed> seed = std::nullopt)
+        : depth_(depth), new_vertices_count_(new_vertices_count), seed_(seed) {}
 
     Graph::Depth depth() const { return depth_; }
     int new_vertices_count() const { return new_vertices_count_; }
+    std::optional<Seed> seed() const { return seed_; }
 
    private:
     Graph::Depth depth_ = 0;
     int new_vertices_count_ = 0;
+    std::optional<Seed> seed_;
+  };
+
+  // Generation split into short steps on the calling thread, so a scheduler
+  // can interleave many graphs. Every step grows one grey branch of the
+  // root or runs one of the green, yellow and red phases. A suspended task
+  // keeps only the graph and the index of the next branch. Gives the same
+  // graph as generate() with the same seed.
+  class Task {
+   public:
+    Task(const Params& params,
+         const CancellationToken& token,
+         GenerationStatistics* statistics);
+
+    // Returns false once the generation is finished or stopped
+    bool resume();
+
+    Graph take_graph() { return std::move(graph_); }
+    const CancellationToken& token() const { return token_; }
+
+   private:
+    enum class Phase { Grey, Green, Yellow, Red, Done };
+
+    void grow_grey_branch();
+
+    Params params_;
+    Seed seed_;
+    CancellationToken token_;
+    GenerationStatistics* statistics_;
+    Graph graph_;
+    Graph::VertexId root_id_ = 0;
+    int next_branch_index_ = 0;
+    Phase phase_ = Phase::Done;
   };
 
   explicit GraphGenerator(Params&& params) : params_(std::move(params)) {}
 
   Graph generate() const;
 
- private:
-  void generate_grey_edges(Graph& graph, Graph::VertexId root_id) const;
-  void generate_grey_branch(Graph& graph,
-                            Graph::VertexId root_vertex_id,
-                            Graph::Depth current_depth,
-                            std::mutex& graph_mutex) const;
+  // Stops as soon as the token is stopped and returns the truncated graph,
+  // which is still well-formed; token.status() tells why it was truncated.
+  // Phase times and lock waits are accounted if statistics are given.
+  // Generations with the same seed give the same graph, ids included, by
+  // this call or by a Task, as every phase and grey branch draws from its
+  // own engine and the edges are added in a fixed order.
+  Graph generate(const CancellationToken& token,
+                 GenerationStatistics* statistics = nullptr) const;
 
+  Task make_task(const CancellationToken& token,
+                 GenerationStatistics* statistics = nullptr) const;
+
+  // Expected amount of vertices, used to order generation jobs by size.
+  double estimate_vertices_count() const;
+
+ private:
   Params params_ = Params(0, 0);
 };
 }  // namespace uni_course_cpp
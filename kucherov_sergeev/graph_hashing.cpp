@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "graph_hashing.hpp"
+
+namespace uni_course_cpp {
+namespace {
+static constexpr Graph::VertexId kNoParent = -1;
+
+std::uint64_t mix(std::uint64_t value) {
+  value += 0x9e3779b97f4a7c15ull;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+  return value ^ (value >> 31);
+}
+
+std::uint64_t combine(std::uint64_t seed, std::uint64_t value) {
+  return mix(seed ^ mix(value));
+}
+
+// Sums are order independent, so they hash multisets without sorting
+struct SubtreeHashes {
+  std::vector<std::uint64_t> vertex_hashes;
+  std::uint64_t roots_hash = 0;
+};
+
+SubtreeHashes get_subtree_hashes(
+    const Graph& graph,
+    const std::vector<Graph::VertexId>& parent_ids,
+    const std::vector<std::uint64_t>& signatures) {
+  auto hashes = SubtreeHashes();
+  hashes.vertex_hashes.resize(signatures.size());
+  auto children_hashes = std::vector<std::uint64_t>(signatures.size(), 0);
+
+  for (Graph::Depth depth = graph.get_depth(); depth >= 0; depth--) {
+    for (const auto vertex_id : graph.get_depth_vertex_ids(depth)) {
+      const auto vertex_hash =
+          combine(combine(depth, signatures[vertex_id]),
+                  children_hashes[vertex_id]);
+      hashes.vertex_hashes[vertex_id] = vertex_hash;
+
+      const auto parent_id = parent_ids[vertex_id];
+      (parent_id == kNoParent ? hashes.roots_hash
+                              : children_hashes[parent_id]) += mix(vertex_hash);
+    }
+  }
+
+  return hashes;
+}
+
+// New ids of the vertices in the preorder walk, siblings with equal hashes
+// keep the order of their ids
+std::vector<Graph::VertexId> get_canonical_vertex_ids(
+    const StructuralHashes& hashes) {
+  const auto& vertex_hashes = hashes.vertex_hashes;
+  const auto vertices_count = vertex_hashes.size();
+  const auto is_visited_before = [&vertex_hashes](Graph::VertexId first,
+                                                  Graph::VertexId second) {
+    return std::pair(vertex_hashes[first], first) <
+           std::pair(vertex_hashes[second], second);
+  };
+
+  auto children_ids = std::vector<std::vector<Graph::VertexId>>(
+      vertices_count + 1);
+  // The roots of the forest are the children of a virtual vertex
+  const Graph::VertexId roots_parent_id = vertices_count;
+  for (Graph::VertexId vertex_id = 0;
+       static_cast<std::size_t>(vertex_id) < vertices_count; vertex_id++) {
+    const auto parent_id = hashes.parent_ids[vertex_id];
+    children_ids[parent_id == kNoParent ? roots_parent_id : parent_id]
+        .push_back(vertex_id);
+  }
+  for (auto& ids : children_ids) {
+    std::sort(ids.begin(), ids.end(), is_visited_before);
+  }
+
+  auto canonical_ids = std::vector<Graph::VertexId>(vertices_count);
+  Graph::VertexId next_canonical_id = 0;
+  // Children are pushed in reverse, so the first one is visited first
+  auto stack = std::vector<Graph::VertexId>(
+      children_ids[roots_parent_id].rbegin(),
+      children_ids[roots_parent_id].rend());
+  while (!stack.empty()) {
+    const auto vertex_id = stack.back();
+    stack.pop_back();
+    canonical_ids[vertex_id] = next_canonical_id++;
+    const auto& ids = children_ids[vertex_id];
+    stack.insert(stack.end(), ids.rbegin(), ids.rend());
+  }
+
+  return canonical_ids;
+}
+}  // namespace
+
+StructuralHashes get_structural_hashes(const Graph& graph) {
+  const auto vertices_count = graph.get_vertices().size();
+  const auto& edges = graph.get_edges();
+
+  auto parent_ids = std::vector<Graph::VertexId>(vertices_count, kNoParent);
+  auto signatures = std::vector<std::uint64_t>(vertices_count, 0);
+  for (const auto& [edge_id, edge] : edges) {
+    const auto color = static_cast<std::uint64_t>(edge.color());
+    signatures[edge.from_vertex_id()] += mix(2 * color);
+    signatures[edge.to_vertex_id()] += mix(2 * color + 1);
+    if (edge.color() == Graph::Edge::Color::Grey) {
+      parent_ids[edge.to_vertex_id()] = edge.from_vertex_id();
+    }
+  }
+
+  const auto first_round = get_subtree_hashes(graph, parent_ids, signatures);
+
+  for (const auto& [edge_id, edge] : edges) {
+    if (edge.color() == Graph::Edge::Color::Grey) {
+      continue;
+    }
+    const auto color = static_cast<std::uint64_t>(edge.color());
+    const auto from_vertex_id = edge.from_vertex_id();
+    const auto to_vertex_id = edge.to_vertex_id();
+    signatures[from_vertex_id] +=
+        combine(2 * color, first_round.vertex_hashes[to_vertex_id]);
+    signatures[to_vertex_id] +=
+        combine(2 * color + 1, first_round.vertex_hashes[from_vertex_id]);
+  }
+
+  auto second_round = get_subtree_hashes(graph, parent_ids, signatures);
+  const auto graph_hash =
+      combine(combine(graph.get_depth(), vertices_count),
+              combine(edges.size(), second_round.roots_hash));
+  return {std::move(parent_ids), std::move(second_round.vertex_hashes),
+          graph_hash};
+}
+
+std::uint64_t get_structural_hash(const Graph& graph) {
+  return get_structural_hashes(graph).graph_hash;
+}
+
+bool CanonicalForm::Edge::operator==(const Edge& other) const {
+  return from_vertex_id == other.from_vertex_id &&
+         to_vertex_id == other.to_vertex_id && color == other.color;
+}
+
+bool CanonicalForm::Edge::operator<(const Edge& other) const {
+  return std::tuple(from_vertex_id, to_vertex_id, color) <
+         std::tuple(other.from_vertex_id, other.to_vertex_id, other.color);
+}
+
+bool CanonicalForm::operator==(const CanonicalForm& other) const {
+  return vertex_depths == other.vertex_depths && edges == other.edges;
+}
+
+bool CanonicalForm::operator!=(const CanonicalForm& other) const {
+  return !(*this == other);
+}
+
+CanonicalForm get_canonical_form(const Graph& graph) {
+  return get_canonical_form(graph, get_structural_hashes(graph));
+}
+
+CanonicalForm get_canonical_form(const Graph& graph,
+                                 const StructuralHashes& hashes) {
+  const auto canonical_ids = get_canonical_vertex_ids(hashes);
+
+  auto form = CanonicalForm();
+  form.vertex_depths.resize(canonical_ids.size());
+  for (Graph::VertexId vertex_id = 0;
+       static_cast<std::size_t>(vertex_id) < canonical_ids.size();
+       vertex_id++) {
+    form.vertex_depths[canonical_ids[vertex_id]] =
+        graph.get_vertex_depth(vertex_id);
+  }
+
+  form.edges.reserve(graph.get_edges().size());
+  for (const auto& [edge_id, edge] : graph.get_edges()) {
+    form.edges.push_back({canonical_ids[edge.from_vertex_id()],
+                          canonical_ids[edge.to_vertex_id()], edge.color()});
+  }
+  std::sort(form.edges.begin(), form.edges.end());
+
+  return form;
+}
+}  // namespace uni_course_cpp
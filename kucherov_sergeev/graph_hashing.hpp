@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace uni_course_cpp {
+// Isomorphic graphs get the same hash, ids and storage order don't matter.
+// Each vertex is hashed from its depth, the colors of its edges and the
+// multiset of its children's hashes, bottom-up along the grey tree. A second
+// round adds the first round hashes of the far ends of non-grey edges.
+// Linear in the graph size. Different graphs may collide, if unlikely.
+std::uint64_t get_structural_hash(const Graph& graph);
+
+// The vertex hashes behind the graph hash along with the grey tree they
+// were computed over. Both the hash and the canonical form are derived from
+// them, so a graph needing both is hashed once.
+struct StructuralHashes {
+  std::vector<Graph::VertexId> parent_ids;
+  std::vector<std::uint64_t> vertex_hashes;
+  std::uint64_t graph_hash = 0;
+};
+
+StructuralHashes get_structural_hashes(const Graph& graph);
+
+// The graph with its vertices renumbered in a preorder walk of the grey tree,
+// which visits siblings in the order of their structural hashes. Equal forms
+// prove the graphs isomorphic, whatever the hashes. Isomorphic graphs may
+// still get different forms when siblings have equal hashes, so a
+// comparison errs on the side of calling graphs different.
+struct CanonicalForm {
+  struct Edge {
+    Graph::VertexId from_vertex_id;
+    Graph::VertexId to_vertex_id;
+    Graph::Edge::Color color;
+
+    bool operator==(const Edge& other) const;
+    bool operator<(const Edge& other) const;
+  };
+
+  // By the new vertex ids
+  std::vector<Graph::Depth> vertex_depths;
+  // Sorted
+  std::vector<Edge> edges;
+
+  bool operator==(const CanonicalForm& other) const;
+  bool operator!=(const CanonicalForm& other) const;
+};
+
+// O(n log n), the children of every vertex are sorted by their hashes
+CanonicalForm get_canonical_form(const Graph& graph);
+// Reuses the hashes computed for the same graph
+CanonicalForm get_canonical_form(const Graph& graph,
+                                 const StructuralHashes& hashes);
+}  // namespace uni_course_cpp
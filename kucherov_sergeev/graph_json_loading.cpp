@@ -0,0 +1,372 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "graph_json_loading.hpp"
+#include "graph_printing.hpp"
+
+namespace uni_course_cpp {
+namespace loading {
+namespace json {
+namespace {
+struct VertexRecord {
+  Graph::VertexId id = -1;
+  Graph::Depth depth = -1;
+  std::size_t edge_ids_begin = 0;
+  std::size_t edge_ids_end = 0;
+};
+
+struct EdgeRecord {
+  Graph::EdgeId id = -1;
+  Graph::VertexId from_vertex_id = -1;
+  Graph::VertexId to_vertex_id = -1;
+  Graph::Edge::Color color = Graph::Edge::Color::Grey;
+};
+
+// Walks the document once. Strings are found with memchr, which the C
+// library vectorizes, and numbers are read with from_chars.
+class Scanner {
+ public:
+  explicit Scanner(std::string_view text)
+      : begin_(text.data()),
+        current_(text.data()),
+        end_(text.data() + text.size()) {}
+
+  bool consume(char character) {
+    skip_whitespace();
+    if (current_ != end_ && *current_ == character) {
+      current_++;
+      return true;
+    }
+    return false;
+  }
+
+  void expect(char character) {
+    if (!consume(character)) {
+      fail(std::string("Expected '") + character + "'");
+    }
+  }
+
+  std::string_view read_string() {
+    expect('"');
+    const auto* const string_end = static_cast<const char*>(
+        std::memchr(current_, '"', end_ - current_));
+    if (string_end == nullptr) {
+      fail("Unterminated string");
+    }
+    const auto string = std::string_view(current_, string_end - current_);
+    if (string.find('\\') != std::string_view::npos) {
+      fail("Escaped strings are not supported");
+    }
+    current_ = string_end + 1;
+    return string;
+  }
+
+  int read_int() {
+    skip_whitespace();
+    int number = 0;
+    const auto result = std::from_chars(current_, end_, number);
+    if (result.ec != std::errc()) {
+      fail("Expected an integer");
+    }
+    current_ = result.ptr;
+    return number;
+  }
+
+  void expect_end() {
+    skip_whitespace();
+    if (current_ != end_) {
+      fail("Unexpected trailing data");
+    }
+  }
+
+  [[noreturn]] void fail(const std::string& message) const {
+    throw std::runtime_error(message + " at offset " +
+                             std::to_string(current_ - begin_));
+  }
+
+ private:
+  void skip_whitespace() {
+    while (current_ != end_ && (*current_ == ' ' || *current_ == '\n' ||
+                                *current_ == '\t' || *current_ == '\r')) {
+      current_++;
+    }
+  }
+
+  const char* begin_;
+  const char* current_;
+  const char* end_;
+};
+
+template <typename ParseField>
+void parse_object(Scanner& scanner, const ParseField& parse_field) {
+  scanner.expect('{');
+  if (scanner.consume('}')) {
+    return;
+  }
+  do {
+    const auto key = scanner.read_string();
+    scanner.expect(':');
+    parse_field(key);
+  } while (scanner.consume(','));
+  scanner.expect('}');
+}
+
+template <typename ParseElement>
+void parse_array(Scanner& scanner, const ParseElement& parse_element) {
+  scanner.expect('[');
+  if (scanner.consume(']')) {
+    return;
+  }
+  do {
+    parse_element();
+  } while (scanner.consume(','));
+  scanner.expect(']');
+}
+
+Graph::Edge::Color parse_edge_color(Scanner& scanner) {
+  const auto color_name = scanner.read_string();
+  for (int color = 0; color < Graph::Edge::kColorsCount; color++) {
+    const auto edge_color = static_cast<Graph::Edge::Color>(color);
+    if (color_name == printing::get_edge_color_name(edge_color)) {
+      return edge_color;
+    }
+  }
+  scanner.fail("Unknown edge color");
+}
+
+// Maps the ids of the document to dense ids in the same order. The ids may
+// be sparse, e.g. when vertices and edges are numbered by one counter.
+class IdMap {
+ public:
+  template <typename Record>
+  IdMap(const std::vector<Record>& records, const char* records_name) {
+    ids_.reserve(records.size());
+    for (std::size_t i = 0; i < records.size(); i++) {
+      ids_.push_back({records[i].id, i});
+    }
+    std::sort(ids_.begin(), ids_.end());
+    const auto duplicate = std::adjacent_find(
+        ids_.begin(), ids_.end(), [](const auto& first, const auto& second) {
+          return first.first == second.first;
+        });
+    if (duplicate != ids_.end()) {
+      throw std::runtime_error(std::string(records_name) + " id " +
+                               std::to_string(duplicate->first) +
+                               " isn't unique");
+    }
+  }
+
+  // -1 for ids missing from the document
+  int get_dense_id(int id) const {
+    const auto position = std::lower_bound(
+        ids_.begin(), ids_.end(), std::pair(id, std::size_t{0}));
+    return position != ids_.end() && position->first == id
+               ? position - ids_.begin()
+               : -1;
+  }
+
+  int get_id(int dense_id) const { return ids_[dense_id].first; }
+
+  std::size_t get_record_index(int dense_id) const {
+    return ids_[dense_id].second;
+  }
+
+ private:
+  // Ids of the document with the positions of their records, sorted
+  std::vector<std::pair<int, std::size_t>> ids_;
+};
+
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& file_path) {
+    const int file_descriptor = ::open(file_path.c_str(), O_RDONLY);
+    if (file_descriptor == -1) {
+      throw std::runtime_error("Failed to open file " + file_path);
+    }
+
+    struct stat file_stat;
+    if (::fstat(file_descriptor, &file_stat) != 0) {
+      ::close(file_descriptor);
+      throw std::runtime_error("Failed to read file " + file_path);
+    }
+
+    size_ = file_stat.st_size;
+    if (size_ != 0) {
+      data_ =
+          ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    }
+    ::close(file_descriptor);
+    if (data_ == MAP_FAILED) {
+      data_ = nullptr;
+      throw std::runtime_error("Failed to map file " + file_path);
+    }
+  }
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      ::munmap(data_, size_);
+    }
+  }
+
+  MappedFile(const MappedFile& other) = delete;
+  void operator=(const MappedFile& other) = delete;
+
+  std::string_view text() const {
+    return std::string_view(static_cast<const char*>(data_), size_);
+  }
+
+ private:
+  void* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+}  // namespace
+
+Graph parse_graph(std::string_view graph_json) {
+  auto scanner = Scanner(graph_json);
+
+  Graph::Depth depth = -1;
+  auto vertices = std::vector<VertexRecord>();
+  auto edges = std::vector<EdgeRecord>();
+  auto vertex_edge_ids = std::vector<Graph::EdgeId>();
+
+  const auto parse_vertex = [&scanner, &vertices, &vertex_edge_ids]() {
+    auto& vertex = vertices.emplace_back();
+    vertex.edge_ids_begin = vertex_edge_ids.size();
+    vertex.edge_ids_end = vertex_edge_ids.size();
+    parse_object(scanner, [&scanner, &vertex,
+                           &vertex_edge_ids](std::string_view key) {
+      if (key == "id") {
+        vertex.id = scanner.read_int();
+      } else if (key == "depth") {
+        vertex.depth = scanner.read_int();
+      } else if (key == "edge_ids") {
+        vertex.edge_ids_begin = vertex_edge_ids.size();
+        parse_array(scanner, [&scanner, &vertex_edge_ids]() {
+          vertex_edge_ids.push_back(scanner.read_int());
+        });
+        vertex.edge_ids_end = vertex_edge_ids.size();
+      } else {
+        scanner.fail("Unknown vertex field");
+      }
+    });
+  };
+
+  const auto parse_edge = [&scanner, &edges]() {
+    auto& edge = edges.emplace_back();
+    parse_object(scanner, [&scanner, &edge](std::string_view key) {
+      if (key == "id") {
+        edge.id = scanner.read_int();
+      } else if (key == "color") {
+        edge.color = parse_edge_color(scanner);
+      } else if (key == "vertex_ids") {
+        scanner.expect('[');
+        edge.from_vertex_id = scanner.read_int();
+        scanner.expect(',');
+        edge.to_vertex_id = scanner.read_int();
+        scanner.expect(']');
+      } else {
+        scanner.fail("Unknown edge field");
+      }
+    });
+  };
+
+  parse_object(scanner, [&](std::string_view key) {
+    if (key == "depth") {
+      depth = scanner.read_int();
+    } else if (key == "vertices") {
+      parse_array(scanner, parse_vertex);
+    } else if (key == "edges") {
+      parse_array(scanner, parse_edge);
+    } else {
+      scanner.fail("Unknown graph field");
+    }
+  });
+  scanner.expect_end();
+
+  const auto vertex_ids = IdMap(vertices, "Vertex");
+  const auto edge_ids = IdMap(edges, "Edge");
+  const auto vertices_count = vertices.size();
+  const auto edges_count = edges.size();
+
+  for (auto& edge : edges) {
+    const auto from_vertex_id = vertex_ids.get_dense_id(edge.from_vertex_id);
+    const auto to_vertex_id = vertex_ids.get_dense_id(edge.to_vertex_id);
+    if (from_vertex_id == -1 || to_vertex_id == -1) {
+      throw std::runtime_error("Edge " + std::to_string(edge.id) +
+                               " refers to a missing vertex");
+    }
+    edge.from_vertex_id = from_vertex_id;
+    edge.to_vertex_id = to_vertex_id;
+  }
+
+  auto graph = Graph();
+  graph.reserve(vertices_count, edges_count);
+  // Vertices are added just before their first edge, as the generator does,
+  // otherwise every one of them would wait in the default depth bucket
+  std::size_t added_vertices_count = 0;
+  const auto add_vertices = [&graph, &added_vertices_count](
+                                std::size_t vertices_count) {
+    for (; added_vertices_count < vertices_count; added_vertices_count++) {
+      graph.add_vertex();
+    }
+  };
+
+  for (std::size_t edge_id = 0; edge_id < edges_count; edge_id++) {
+    const auto& edge = edges[edge_ids.get_record_index(edge_id)];
+    add_vertices(std::max(edge.from_vertex_id, edge.to_vertex_id) + 1);
+    graph.add_edge(edge.from_vertex_id, edge.to_vertex_id);
+    if (graph.get_edges().at(edge_id).color() != edge.color) {
+      throw std::runtime_error("Edge " + std::to_string(edge.id) +
+                               " has an inconsistent color");
+    }
+  }
+  add_vertices(vertices_count);
+
+  // Adjacency lists are compared as sets, other generators may order them
+  // differently
+  auto document_edge_ids = std::vector<Graph::EdgeId>();
+  auto graph_edge_ids = std::vector<Graph::EdgeId>();
+  for (std::size_t vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    const auto& vertex = vertices[vertex_ids.get_record_index(vertex_id)];
+    document_edge_ids.clear();
+    for (auto i = vertex.edge_ids_begin; i < vertex.edge_ids_end; i++) {
+      document_edge_ids.push_back(edge_ids.get_dense_id(vertex_edge_ids[i]));
+    }
+    const auto& connected_edge_ids = graph.get_connected_edge_ids(vertex_id);
+    graph_edge_ids.assign(connected_edge_ids.begin(),
+                          connected_edge_ids.end());
+    std::sort(document_edge_ids.begin(), document_edge_ids.end());
+    std::sort(graph_edge_ids.begin(), graph_edge_ids.end());
+    if (document_edge_ids != graph_edge_ids) {
+      throw std::runtime_error("Vertex " + std::to_string(vertex.id) +
+                               " has inconsistent edge ids");
+    }
+    if (graph.get_vertex_depth(vertex_id) != vertex.depth) {
+      throw std::runtime_error("Vertex " + std::to_string(vertex.id) +
+                               " has an inconsistent depth");
+    }
+  }
+
+  if (graph.get_depth() != depth) {
+    throw std::runtime_error("Graph has an inconsistent depth");
+  }
+
+  return graph;
+}
+
+Graph read_graph(const std::string& file_path) {
+  const auto file = MappedFile(file_path);
+  return parse_graph(file.text());
+}
+}  // namespace json
+}  // namespace loading
+}  // namespace uni_course_cpp
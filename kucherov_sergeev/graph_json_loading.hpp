@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "graph.hpp"
+
+namespace uni_course_cpp {
+namespace loading {
+namespace json {
+// Reads the document written by printing::json::write_graph, or by another
+// generator with the same fields. The graph is rebuilt by adding its edges
+// in id order, which reproduces the same colors and depths, and then
+// checked against the document. Sparse ids, e.g. vertices and edges
+// numbered by one counter, are mapped to dense ids in the same order, dense
+// ids are kept as they are. Throws std::runtime_error on malformed JSON or
+// inconsistent ids.
+Graph parse_graph(std::string_view graph_json);
+
+Graph read_graph(const std::string& file_path);
+}  // namespace json
+}  // namespace loading
+}  // namespace uni_course_cpp
@@ -1,71 +1,553 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
 #include "graph_json_printing.hpp"
 #include "graph_printing.hpp"
 
 namespace uni_course_cpp {
 namespace printing {
 namespace json {
-std::string print_vertex(const Graph::Vertex& vertex, const Graph& graph) {
-  std::string vertex_json =
-      "{\"id\":" + std::to_string(vertex.id()) + ",\"edge_ids\":[";
-  const auto& connected_edge_ids = graph.get_connected_edge_ids(vertex.id());
+namespace {
+static constexpr std::size_t kElementBufferSize = 256;
+static constexpr std::size_t kChunkElementsCount = 1 << 14;
+static constexpr std::size_t kChunkBufferSize = 1 << 16;
+static constexpr int kWindowChunksPerThread = 4;
+static constexpr int kMaxWindowChunksCount = 512;
+
+struct Chunk {
+  enum class Kind { Text, Vertices, Edges };
+
+  Kind kind = Kind::Text;
+  std::string_view text;
+  std::size_t begin = 0;
+  std::size_t end = 0;
+};
+
+// Upper bounds of the formatted values, "-2147483648" and "yellow"
+static constexpr std::size_t kMaxIntLength = 11;
+static constexpr std::size_t kMaxColorNameLength = 6;
+
+// Copies fragments and numbers straight into the space reserved in a writer
+class Cursor {
+ public:
+  explicit Cursor(char* position) : position_(position) {}
+
+  template <std::size_t Size>
+  void write(const Literal<Size>& literal) {
+    std::memcpy(position_, literal.characters.data(), Size);
+    position_ += Size;
+  }
+
+  void write(std::string_view string) {
+    std::memcpy(position_, string.data(), string.size());
+    position_ += string.size();
+  }
+
+  void write(int number) {
+    position_ = std::to_chars(position_, position_ + kMaxIntLength, number).ptr;
+  }
+
+  const char* position() const { return position_; }
 
-  if (connected_edge_ids.size() != 0) {
-    for (const auto edge_id : connected_edge_ids) {
-      vertex_json += std::to_string(edge_id) + ",";
+ private:
+  char* position_;
+};
+
+std::string_view get_element_prefix(std::size_t index,
+                                    const GraphFragments& fragments) {
+  return index == 0 ? fragments.first_element : fragments.next_element;
+}
+
+void write_all(int file_descriptor, std::vector<iovec>& io_vectors) {
+  auto* io_vector = io_vectors.data();
+  int io_vectors_count = io_vectors.size();
+  while (io_vectors_count > 0) {
+    const auto written_size =
+        ::writev(file_descriptor, io_vector, io_vectors_count);
+    if (written_size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("Failed to write file");
     }
 
-    vertex_json.pop_back();
+    std::size_t remaining_size = written_size;
+    while (io_vectors_count > 0 && remaining_size >= io_vector->iov_len) {
+      remaining_size -= io_vector->iov_len;
+      io_vector++;
+      io_vectors_count--;
+    }
+    if (io_vectors_count > 0) {
+      io_vector->iov_base =
+          static_cast<char*>(io_vector->iov_base) + remaining_size;
+      io_vector->iov_len -= remaining_size;
+    }
   }
+}
 
-  vertex_json +=
-      "],\"depth\":" + std::to_string(graph.get_vertex_depth(vertex.id()));
+// Buffers of the chunks being formatted and written, shared by the
+// formatting threads and the thread appending the chunks to the file. A
+// chunk is taken only once the chunk which used its buffer before is
+// written, so no more than the ring is kept in memory.
+class ChunkRing {
+ public:
+  ChunkRing(std::size_t chunks_count, std::size_t ring_size)
+      : chunks_count_(chunks_count),
+        buffers_(ring_size),
+        is_formatted_(ring_size, false) {}
 
-  vertex_json += "}";
+  // False once every chunk is taken or the writing has failed
+  bool take_chunk(std::size_t& chunk_index) {
+    auto lock = std::unique_lock(mutex_);
+    chunks_written_.wait(lock, [this]() {
+      return error_ || next_chunk_index_ == chunks_count_ ||
+             next_chunk_index_ < written_chunks_count_ + buffers_.size();
+    });
+    if (error_ || next_chunk_index_ == chunks_count_) {
+      return false;
+    }
+    chunk_index = next_chunk_index_++;
+    return true;
+  }
+
+  std::string& get_buffer(std::size_t chunk_index) {
+    return buffers_[chunk_index % buffers_.size()];
+  }
+
+  void set_formatted(std::size_t chunk_index) {
+    {
+      const std::lock_guard lock(mutex_);
+      is_formatted_[chunk_index % buffers_.size()] = true;
+    }
+    chunk_formatted_.notify_all();
+  }
 
+  // Waits for the next chunk to write and returns the end of the formatted
+  // chunks following it, at most max_count of them. Rethrows the error of
+  // a formatting thread.
+  std::size_t wait_formatted(std::size_t max_count) {
+    auto lock = std::unique_lock(mutex_);
+    chunk_formatted_.wait(lock, [this]() {
+      return error_ || is_formatted_[written_chunks_count_ % buffers_.size()];
+    });
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    auto end = written_chunks_count_;
+    const auto max_end = std::min(end + max_count, chunks_count_);
+    while (end < max_end && is_formatted_[end % buffers_.size()]) {
+      end++;
+    }
+    return end;
+  }
+
+  void set_written(std::size_t end) {
+    {
+      const std::lock_guard lock(mutex_);
+      for (auto i = written_chunks_count_; i < end; i++) {
+        is_formatted_[i % buffers_.size()] = false;
+      }
+      written_chunks_count_ = end;
+    }
+    chunks_written_.notify_all();
+  }
+
+  // Stops the formatting threads, the first error is kept
+  void fail(std::exception_ptr error) {
+    {
+      const std::lock_guard lock(mutex_);
+      if (!error_) {
+        error_ = error;
+      }
+    }
+    chunk_formatted_.notify_all();
+    chunks_written_.notify_all();
+  }
+
+ private:
+  const std::size_t chunks_count_;
+  std::vector<std::string> buffers_;
+  std::mutex mutex_;
+  std::condition_variable chunk_formatted_;
+  std::condition_variable chunks_written_;
+  std::vector<bool> is_formatted_;
+  std::size_t next_chunk_index_ = 0;
+  std::size_t written_chunks_count_ = 0;
+  std::exception_ptr error_;
+};
+
+template <typename IsEdgeWritten>
+void write_vertex_fields(Graph::VertexId vertex_id,
+                         const Graph& graph,
+                         BufferedWriter& writer,
+                         const IsEdgeWritten& is_edge_written) {
+  using Layout = VertexLayout;
+  static constexpr auto kMaxHeadSize =
+      Layout::kId.size() + kMaxIntLength + Layout::kEdgeIds.size();
+  static constexpr auto kMaxEdgeIdSize =
+      Layout::kEdgeIdsSeparator.size() + kMaxIntLength;
+  static constexpr auto kMaxTailSize =
+      Layout::kDepth.size() + kMaxIntLength + Layout::kEnd.size();
+
+  auto cursor = Cursor(writer.reserve(kMaxHeadSize));
+  cursor.write(Layout::kId);
+  cursor.write(vertex_id);
+  cursor.write(Layout::kEdgeIds);
+  writer.commit(cursor.position());
+
+  bool is_first_edge = true;
+  for (const auto edge_id : graph.get_connected_edge_ids(vertex_id)) {
+    if (!is_edge_written(edge_id)) {
+      continue;
+    }
+    cursor = Cursor(writer.reserve(kMaxEdgeIdSize));
+    if (!is_first_edge) {
+      cursor.write(Layout::kEdgeIdsSeparator);
+    }
+    cursor.write(edge_id);
+    writer.commit(cursor.position());
+    is_first_edge = false;
+  }
+
+  cursor = Cursor(writer.reserve(kMaxTailSize));
+  cursor.write(Layout::kDepth);
+  cursor.write(graph.get_vertex_depth(vertex_id));
+  cursor.write(Layout::kEnd);
+  writer.commit(cursor.position());
+}
+
+template <typename Elements, typename Callback>
+void for_each_element(const Elements& elements,
+                      ElementOrder order,
+                      const Callback& callback) {
+  if (order == ElementOrder::Storage) {
+    for (const auto& [id, element] : elements) {
+      callback(element);
+    }
+    return;
+  }
+
+  for (typename Elements::key_type id = 0;
+       static_cast<std::size_t>(id) < elements.size(); id++) {
+    callback(elements.at(id));
+  }
+}
+}  // namespace
+
+std::string print_vertex(const Graph::Vertex& vertex, const Graph& graph) {
+  std::string vertex_json;
+  {
+    auto writer = StringWriter(vertex_json, kElementBufferSize);
+    write_vertex(vertex, graph, writer);
+  }
   return vertex_json;
 }
 
 std::string print_edge(const Graph::Edge& edge) {
-  std::string edge_json =
-      "{\"id\":" + std::to_string(edge.id()) + ",\"vertex_ids\":[";
+  std::string edge_json;
+  {
+    auto writer = StringWriter(edge_json, kElementBufferSize);
+    write_edge(edge, writer);
+  }
+  return edge_json;
+}
 
-  edge_json += std::to_string(edge.from_vertex_id()) + "," +
-               std::to_string(edge.to_vertex_id());
-  edge_json += "],\"color\":\"" + print_edge_color(edge.color()) + "\"";
-  edge_json += "}";
+std::string print_graph(const Graph& graph, ElementOrder order, Style style) {
+  std::string graph_json;
+  {
+    auto writer = StringWriter(graph_json);
+    write_graph(graph, writer, order, style);
+  }
+  return graph_json;
+}
 
-  return edge_json;
+void write_vertex(const Graph::Vertex& vertex,
+                  const Graph& graph,
+                  BufferedWriter& writer) {
+  write_vertex_fields(vertex.id(), graph, writer,
+                      [](Graph::EdgeId) { return true; });
+}
+
+void write_edge(const Graph::Edge& edge, BufferedWriter& writer) {
+  using Layout = EdgeLayout;
+  static constexpr auto kMaxSize =
+      Layout::kId.size() + Layout::kVertexIds.size() +
+      Layout::kVertexIdsSeparator.size() + Layout::kColor.size() +
+      Layout::kEnd.size() + 3 * kMaxIntLength + kMaxColorNameLength;
+
+  auto cursor = Cursor(writer.reserve(kMaxSize));
+  cursor.write(Layout::kId);
+  cursor.write(edge.id());
+  cursor.write(Layout::kVertexIds);
+  cursor.write(edge.from_vertex_id());
+  cursor.write(Layout::kVertexIdsSeparator);
+  cursor.write(edge.to_vertex_id());
+  cursor.write(Layout::kColor);
+  cursor.write(get_edge_color_name(edge.color()));
+  cursor.write(Layout::kEnd);
+  writer.commit(cursor.position());
+}
+
+void write_graph(const Graph& graph,
+                 BufferedWriter& writer,
+                 ElementOrder order,
+                 Style style) {
+  const auto& fragments = get_graph_fragments(style);
+  writer.write(fragments.depth);
+  writer.write(graph.get_depth());
+  writer.write(fragments.vertices);
+
+  bool is_first_vertex = true;
+  for_each_element(graph.get_vertices(), order,
+                   [&graph, &writer, &fragments,
+                    &is_first_vertex](const Graph::Vertex& vertex) {
+                     writer.write(is_first_vertex ? fragments.first_element
+                                                  : fragments.next_element);
+                     write_vertex(vertex, graph, writer);
+                     is_first_vertex = false;
+                   });
+
+  writer.write(fragments.edges);
+
+  bool is_first_edge = true;
+  for_each_element(graph.get_edges(), order,
+                   [&writer, &fragments,
+                    &is_first_edge](const Graph::Edge& edge) {
+                     writer.write(is_first_edge ? fragments.first_element
+                                                : fragments.next_element);
+                     write_edge(edge, writer);
+                     is_first_edge = false;
+                   });
+
+  writer.write(fragments.end);
 }
 
-std::string print_graph(const Graph& graph) {
-  const auto& vertices = graph.get_vertices();
+std::string print_graph_slice(const Graph& graph,
+                              const GraphSlice& slice,
+                              Style style) {
+  std::string graph_json;
+  {
+    auto writer = StringWriter(graph_json);
+    write_graph_slice(graph, slice, writer, style);
+  }
+  return graph_json;
+}
+
+void write_graph_slice(const Graph& graph,
+                       const GraphSlice& slice,
+                       BufferedWriter& writer,
+                       Style style) {
+  const auto min_depth = std::max(slice.min_depth, 0);
+  const auto max_depth = std::min(slice.max_depth, graph.get_depth());
+
+  auto is_color_written = std::array<bool, Graph::Edge::kColorsCount>();
+  for (const auto color : slice.colors) {
+    is_color_written[static_cast<int>(color)] = true;
+  }
+
+  const auto is_in_slice = [&graph, min_depth,
+                            max_depth](Graph::VertexId vertex_id) {
+    const auto depth = graph.get_vertex_depth(vertex_id);
+    return min_depth <= depth && depth <= max_depth;
+  };
   const auto& edges = graph.get_edges();
+  const auto is_edge_written = [&edges, &is_color_written,
+                                &is_in_slice](Graph::EdgeId edge_id) {
+    const auto& edge = edges.at(edge_id);
+    return is_color_written[static_cast<int>(edge.color())] &&
+           is_in_slice(edge.from_vertex_id()) &&
+           is_in_slice(edge.to_vertex_id());
+  };
+
+  const auto& fragments = get_graph_fragments(style);
+  writer.write(fragments.depth);
+  writer.write(std::max(max_depth, 0));
+  writer.write(fragments.vertices);
+
+  bool is_first_vertex = true;
+  const auto write_vertices = [&graph, &writer, &fragments, &is_edge_written,
+                               &is_first_vertex](
+                                  const Graph::VertexIds& ids) {
+    for (const auto vertex_id : ids) {
+      writer.write(is_first_vertex ? fragments.first_element
+                                   : fragments.next_element);
+      write_vertex_fields(vertex_id, graph, writer, is_edge_written);
+      is_first_vertex = false;
+    }
+  };
+
+  for (auto depth = min_depth; depth <= max_depth; depth++) {
+    const auto& vertex_ids = graph.get_depth_vertex_ids(depth);
+    // Parallel generation may attach vertices out of id order
+    if (std::is_sorted(vertex_ids.begin(), vertex_ids.end())) {
+      write_vertices(vertex_ids);
+    } else {
+      auto sorted_vertex_ids = vertex_ids;
+      std::sort(sorted_vertex_ids.begin(), sorted_vertex_ids.end());
+      write_vertices(sorted_vertex_ids);
+    }
+  }
+
+  writer.write(fragments.edges);
+
+  bool is_first_edge = true;
+  for (int color = 0; color < Graph::Edge::kColorsCount; color++) {
+    if (!is_color_written[color]) {
+      continue;
+    }
+    for (const auto edge_id :
+         graph.get_color_edge_ids(static_cast<Graph::Edge::Color>(color))) {
+      if (is_edge_written(edge_id)) {
+        writer.write(is_first_edge ? fragments.first_element
+                                   : fragments.next_element);
+        write_edge(edges.at(edge_id), writer);
+        is_first_edge = false;
+      }
+    }
+  }
+
+  writer.write(fragments.end);
+}
+
+void write_graph_parallel(const Graph& graph,
+                          const std::string& file_path,
+                          int threads_count,
+                          ElementOrder order,
+                          Style style) {
+  auto vertices = std::vector<const Graph::Vertex*>();
+  vertices.reserve(graph.get_vertices().size());
+  for_each_element(graph.get_vertices(), order,
+                   [&vertices](const Graph::Vertex& vertex) {
+                     vertices.push_back(&vertex);
+                   });
+
+  auto edges = std::vector<const Graph::Edge*>();
+  edges.reserve(graph.get_edges().size());
+  for_each_element(graph.get_edges(), order,
+                   [&edges](const Graph::Edge& edge) {
+                     edges.push_back(&edge);
+                   });
 
-  std::string graph_json =
-      "{\n\t\"depth\":" + std::to_string(graph.get_depth()) + ",";
+  const auto& fragments = get_graph_fragments(style);
+  const std::string header = std::string(fragments.depth) +
+                             std::to_string(graph.get_depth()) +
+                             std::string(fragments.vertices);
 
-  graph_json += "\n\t\"vertices\": [\n";
-  if (vertices.size() != 0) {
-    for (const auto& [vertex_id, vertex] : vertices) {
-      graph_json += "\t\t" + print_vertex(vertex, graph) + ",\n";
+  auto chunks = std::vector<Chunk>();
+  chunks.push_back({Chunk::Kind::Text, header});
+  for (std::size_t begin = 0; begin < vertices.size();
+       begin += kChunkElementsCount) {
+    chunks.push_back({Chunk::Kind::Vertices, {}, begin,
+                      std::min(begin + kChunkElementsCount, vertices.size())});
+  }
+  chunks.push_back({Chunk::Kind::Text, fragments.edges});
+  for (std::size_t begin = 0; begin < edges.size();
+       begin += kChunkElementsCount) {
+    chunks.push_back({Chunk::Kind::Edges, {}, begin,
+                      std::min(begin + kChunkElementsCount, edges.size())});
+  }
+  chunks.push_back({Chunk::Kind::Text, fragments.end});
+
+  const auto write_chunk = [&graph, &vertices, &edges, &fragments](
+                               const Chunk& chunk, std::string& buffer) {
+    buffer.clear();
+    auto writer = StringWriter(buffer, kChunkBufferSize);
+
+    switch (chunk.kind) {
+      case Chunk::Kind::Text:
+        writer.write(chunk.text);
+        break;
+      case Chunk::Kind::Vertices:
+        for (auto i = chunk.begin; i < chunk.end; i++) {
+          writer.write(get_element_prefix(i, fragments));
+          write_vertex(*vertices[i], graph, writer);
+        }
+        break;
+      case Chunk::Kind::Edges:
+        for (auto i = chunk.begin; i < chunk.end; i++) {
+          writer.write(get_element_prefix(i, fragments));
+          write_edge(*edges[i], writer);
+        }
+        break;
     }
-    graph_json.pop_back();
-    graph_json.pop_back();
+  };
+
+  const int file_descriptor =
+      ::open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (file_descriptor == -1) {
+    throw std::runtime_error("Failed to open file " + file_path);
   }
 
-  graph_json += "\n\t],\n\t\"edges\":[\n";
+  threads_count = std::max(threads_count, 1);
+  const std::size_t window_size =
+      std::min(threads_count * kWindowChunksPerThread, kMaxWindowChunksCount);
+  // The next window is formatted while the current one is written
+  auto ring = ChunkRing(chunks.size(), 2 * window_size);
 
-  if (edges.size() != 0) {
-    for (const auto& [edge_id, edge] : edges) {
-      graph_json += "\t\t" + print_edge(edge) + ",\n";
+  const auto format_chunks = [&ring, &chunks, &write_chunk]() {
+    try {
+      std::size_t chunk_index = 0;
+      while (ring.take_chunk(chunk_index)) {
+        write_chunk(chunks[chunk_index], ring.get_buffer(chunk_index));
+        ring.set_formatted(chunk_index);
+      }
+    } catch (const std::exception&) {
+      ring.fail(std::current_exception());
     }
-    graph_json.pop_back();
-    graph_json.pop_back();
+  };
+
+  auto threads = std::vector<std::thread>();
+  threads.reserve(threads_count);
+  for (int i = 0; i < threads_count; i++) {
+    threads.emplace_back(format_chunks);
   }
 
-  graph_json += "\n\t]\n}\n";
+  try {
+    auto io_vectors = std::vector<iovec>();
+    io_vectors.reserve(window_size);
+    for (std::size_t written_end = 0; written_end < chunks.size();) {
+      const auto formatted_end = ring.wait_formatted(window_size);
+      io_vectors.clear();
+      for (auto i = written_end; i < formatted_end; i++) {
+        auto& buffer = ring.get_buffer(i);
+        if (!buffer.empty()) {
+          io_vectors.push_back({buffer.data(), buffer.size()});
+        }
+      }
+      write_all(file_descriptor, io_vectors);
+      ring.set_written(formatted_end);
+      written_end = formatted_end;
+    }
+  } catch (const std::exception&) {
+    ring.fail(std::current_exception());
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    ::close(file_descriptor);
+    throw;
+  }
 
-  return graph_json;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (::close(file_descriptor) != 0) {
+    throw std::runtime_error("Failed to close file " + file_path);
+  }
 }
 }  // namespace json
 }  // namespace printing
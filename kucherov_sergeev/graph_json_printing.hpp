@@ -1,16 +1,73 @@
 #pragma once
 
+#include <limits>
 #include <string>
+#include <vector>
+
+#include "buffered_writer.hpp"
 #include "graph.hpp"
+#include "json_layout.hpp"
 
 namespace uni_course_cpp {
 namespace printing {
 namespace json {
+// Storage follows the hash layout of the graph maps and may differ between
+// equal graphs. Id is deterministic and costs no sorting, as ids are dense.
+enum class ElementOrder { Storage, Id };
+
 std::string print_vertex(const Graph::Vertex& vertex, const Graph& graph);
 
 std::string print_edge(const Graph::Edge& edge);
 
-std::string print_graph(const Graph& graph);
+std::string print_graph(const Graph& graph,
+                        ElementOrder order = ElementOrder::Storage,
+                        Style style = Style::Pretty);
+
+void write_vertex(const Graph::Vertex& vertex,
+                  const Graph& graph,
+                  BufferedWriter& writer);
+
+void write_edge(const Graph::Edge& edge, BufferedWriter& writer);
+
+// Streams the same document as print_graph without building it in memory
+void write_graph(const Graph& graph,
+                 BufferedWriter& writer,
+                 ElementOrder order = ElementOrder::Storage,
+                 Style style = Style::Pretty);
+
+// Part of the graph to export. Only the vertices within the depth range
+// are written, with the edges of the selected colors between them. The
+// vertices' edge ids are limited to the exported edges.
+struct GraphSlice {
+  Graph::Depth min_depth = 0;
+  Graph::Depth max_depth = std::numeric_limits<Graph::Depth>::max();
+  std::vector<Graph::Edge::Color> colors = {
+      Graph::Edge::Color::Grey, Graph::Edge::Color::Green,
+      Graph::Edge::Color::Yellow, Graph::Edge::Color::Red};
+};
+
+// Vertices are written grouped by depth and edges grouped by color, in id
+// order within each group, so neither list is in overall id order.
+// "depth" is the deepest exported level. Reads only the depth buckets and
+// the color index of the graph, so the cost depends on the slice size.
+std::string print_graph_slice(const Graph& graph,
+                              const GraphSlice& slice,
+                              Style style = Style::Pretty);
+void write_graph_slice(const Graph& graph,
+                       const GraphSlice& slice,
+                       BufferedWriter& writer,
+                       Style style = Style::Pretty);
+
+// Writes the same document as print_graph. Vertices and edges are split
+// into chunks, formatted by threads_count threads into separate buffers and
+// appended to the file in order with writev by the calling thread, a window
+// of chunks at a time. The next window is formatted while the current one
+// is written, so only two windows are kept in memory.
+void write_graph_parallel(const Graph& graph,
+                          const std::string& file_path,
+                          int threads_count,
+                          ElementOrder order = ElementOrder::Storage,
+                          Style style = Style::Pretty);
 }  // namespace json
 }  // namespace printing
 }  // namespace uni_course_cpp
@@ -1,6 +1,8 @@
 #include "graph_printing.hpp"
 #include <array>
-#include <map>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
 
 namespace uni_course_cpp {
 namespace printing {
@@ -9,36 +11,39 @@ static constexpr std::array<Graph::Edge::Color, 4> kEdgeColorList = {
     Graph::Edge::Color::Grey, Graph::Edge::Color::Green,
     Graph::Edge::Color::Yellow, Graph::Edge::Color::Red};
 
-std::vector<int> get_vertices_depth_distribution(const Graph& graph) {
-  std::vector<int> vertices_depth_distribution = {};
-  const auto depth = graph.get_depth();
-
-  for (Graph::Depth i = 0; i <= depth; i++) {
-    vertices_depth_distribution.push_back(graph.get_depth_vertex_ids(i).size());
-  }
-
-  return vertices_depth_distribution;
+static constexpr std::array<GenerationPhase, kGenerationPhasesCount>
+    kGenerationPhaseList = {GenerationPhase::Grey, GenerationPhase::Green,
+                            GenerationPhase::Yellow, GenerationPhase::Red};
+
+std::string print_milliseconds(GenerationStatistics::Duration duration) {
+  std::stringstream milliseconds_string;
+  milliseconds_string << std::fixed << std::setprecision(3)
+                      << std::chrono::duration<double, std::milli>(duration)
+                             .count()
+                      << "ms";
+  return milliseconds_string.str();
 }
 
-std::map<Graph::Edge::Color, int> get_edges_color_distribution(
-    const Graph& graph) {
-  std::map<Graph::Edge::Color, int> edges_color_distribution;
-
-  for (const auto color : kEdgeColorList) {
-    edges_color_distribution[color] = 0;
-  }
-
-  const auto& edges = graph.get_edges();
+std::string print_counter(std::int64_t value) {
+  return value == perf::kUnavailable ? "n/a" : std::to_string(value);
+}
 
-  for (const auto& [edge_id, edge] : edges) {
-    edges_color_distribution[edge.color()] += 1;
+std::string print_instructions_per_cycle(const perf::Values& values) {
+  const auto cycles = values[static_cast<int>(perf::Counter::Cycles)];
+  const auto instructions =
+      values[static_cast<int>(perf::Counter::Instructions)];
+  if (cycles <= 0 || instructions == perf::kUnavailable) {
+    return "n/a";
   }
-
-  return edges_color_distribution;
+  std::stringstream ipc_string;
+  ipc_string << std::fixed << std::setprecision(2)
+             << static_cast<double>(instructions) / cycles;
+  return ipc_string.str();
 }
+
 }  // namespace
 
-std::string print_edge_color(Graph::Edge::Color color) {
+std::string_view get_edge_color_name(Graph::Edge::Color color) {
   switch (color) {
     case Graph::Edge::Color::Grey:
       return "grey";
@@ -53,15 +58,17 @@ std::string print_edge_color(Graph::Edge::Color color) {
   }
 }
 
-std::string print_vertices_info(const Graph& graph) {
-  const auto vertices_depth_distribution =
-      get_vertices_depth_distribution(graph);
+std::string print_edge_color(Graph::Edge::Color color) {
+  return std::string(get_edge_color_name(color));
+}
+
+std::string print_vertices_info(const GraphSummary& summary) {
   std::string vertices_string =
-      "vertices: {amount: " + std::to_string(graph.get_vertices().size()) +
+      "vertices: {amount: " + std::to_string(summary.vertices_count) +
       ", distribution: [";
 
-  if (vertices_depth_distribution.size() != 0) {
-    for (const auto vertices_count : vertices_depth_distribution) {
+  if (summary.depth_vertices_counts.size() != 0) {
+    for (const auto vertices_count : summary.depth_vertices_counts) {
       vertices_string += std::to_string(vertices_count) + ", ";
     }
     vertices_string.pop_back();
@@ -72,15 +79,20 @@ std::string print_vertices_info(const Graph& graph) {
   return vertices_string;
 }
 
-std::string print_edges_info(const Graph& graph) {
-  const auto edges_color_distribution = get_edges_color_distribution(graph);
+std::string print_vertices_info(const Graph& graph) {
+  return print_vertices_info(get_graph_summary(graph));
+}
+
+std::string print_edges_info(const GraphSummary& summary) {
   std::string edges_string =
-      "edges: {amount: " + std::to_string(graph.get_edges().size()) +
+      "edges: {amount: " + std::to_string(summary.edges_count) +
       ", distribution: {";
 
   for (const auto color : kEdgeColorList) {
-    edges_string += print_edge_color(color) + ": " +
-                    std::to_string(edges_color_distribution.at(color)) + ", ";
+    edges_string +=
+        print_edge_color(color) + ": " +
+        std::to_string(summary.color_edges_counts[static_cast<int>(color)]) +
+        ", ";
   }
 
   edges_string.pop_back();
@@ -91,14 +103,148 @@ std::string print_edges_info(const Graph& graph) {
   return edges_string;
 }
 
-std::string print_graph(const Graph& graph) {
-  std::string depth_string =
-      "depth: " + std::to_string(graph.get_depth()) + ",";
-  std::string vertices_string = print_vertices_info(graph);
-  std::string edges_string = print_edges_info(graph);
+std::string print_edges_info(const Graph& graph) {
+  return print_edges_info(get_graph_summary(graph));
+}
+
+std::string print_memory_usage(const Graph::MemoryUsage& memory_usage) {
+  return "memory: {total: " + std::to_string(memory_usage.total_bytes) +
+         ", vertices: " + std::to_string(memory_usage.vertices_bytes) +
+         ", edges: " + std::to_string(memory_usage.edges_bytes) +
+         ", adjacency: " + std::to_string(memory_usage.adjacency_bytes) +
+         ", depth_index: " + std::to_string(memory_usage.depth_index_bytes) +
+         ", color_index: " + std::to_string(memory_usage.color_index_bytes) +
+         ", hash_buckets: " + std::to_string(memory_usage.hash_bucket_bytes) +
+         ", slack: " + std::to_string(memory_usage.slack_bytes) + "}";
+}
+
+std::string print_graph(const GraphSummary& summary) {
+  std::string depth_string = "depth: " + std::to_string(summary.depth) + ",";
+  std::string vertices_string = print_vertices_info(summary);
+  std::string edges_string = print_edges_info(summary);
+  if (summary.memory_usage) {
+    edges_string += ",\n\t" + print_memory_usage(*summary.memory_usage);
+  }
 
   return "{\n\t" + depth_string + "\n\t" + vertices_string + "\n\t" +
          edges_string + "\n}";
 }
+
+std::string print_graph(const Graph& graph, bool with_memory_usage) {
+  return print_graph(get_graph_summary(graph, with_memory_usage));
+}
+
+std::string print_generation_status(GenerationStatus status) {
+  switch (status) {
+    case GenerationStatus::Completed:
+      return "completed";
+    case GenerationStatus::DeadlineExceeded:
+      return "deadline exceeded";
+    case GenerationStatus::Cancelled:
+      return "cancelled";
+    default:
+      return "invalid status";
+  }
+}
+
+std::string print_generation_phase(GenerationPhase phase) {
+  switch (phase) {
+    case GenerationPhase::Grey:
+      return "grey";
+    case GenerationPhase::Green:
+      return "green";
+    case GenerationPhase::Yellow:
+      return "yellow";
+    case GenerationPhase::Red:
+      return "red";
+    default:
+      return "invalid phase";
+  }
+}
+
+std::string print_perf_counters(const perf::Values& values) {
+  return "{cycles: " +
+         print_counter(values[static_cast<int>(perf::Counter::Cycles)]) +
+         ", instructions: " +
+         print_counter(values[static_cast<int>(perf::Counter::Instructions)]) +
+         ", ipc: " + print_instructions_per_cycle(values) + ", llc_misses: " +
+         print_counter(values[static_cast<int>(perf::Counter::CacheMisses)]) +
+         ", branch_misses: " +
+         print_counter(values[static_cast<int>(perf::Counter::BranchMisses)]) +
+         "}";
+}
+
+std::string print_generation_statistics(
+    const GenerationStatistics::Snapshot& statistics) {
+  std::string phases_string = "phases: {";
+  for (const auto phase : kGenerationPhaseList) {
+    const auto& phase_times =
+        statistics.phase_times[static_cast<int>(phase)];
+    phases_string += print_generation_phase(phase) +
+                     ": {wall: " + print_milliseconds(phase_times.wall_time) +
+                     ", cpu: " + print_milliseconds(phase_times.cpu_time) +
+                     "}, ";
+  }
+  phases_string.pop_back();
+  phases_string.pop_back();
+  phases_string += "},";
+
+  if (statistics.has_phase_counters) {
+    phases_string += "\n\tphase_counters: {";
+    for (const auto phase : kGenerationPhaseList) {
+      phases_string +=
+          print_generation_phase(phase) + ": " +
+          print_perf_counters(
+              statistics.phase_counters[static_cast<int>(phase)]) +
+          ", ";
+    }
+    phases_string.pop_back();
+    phases_string.pop_back();
+    phases_string += "},";
+  }
+
+  const std::string waits_string =
+      "waits: {queue: " + print_milliseconds(statistics.queue_wait_time) +
+      ", graph_mutex: " + print_milliseconds(statistics.graph_mutex_wait_time) +
+      ", jobs_mutex: " + print_milliseconds(statistics.jobs_mutex_wait_time) +
+      ", grey_jobs_mutex: " +
+      print_milliseconds(statistics.grey_jobs_mutex_wait_time) +
+      "},";
+
+  const std::string throughput_string =
+      "throughput: {vertices: " + std::to_string(statistics.vertices_count) +
+      ", edges: " + std::to_string(statistics.edges_count) +
+      ", vertices_per_second: " +
+      std::to_string(static_cast<long long>(statistics.vertices_per_second)) +
+      ", edges_per_second: " +
+      std::to_string(static_cast<long long>(statistics.edges_per_second)) +
+      "},";
+
+  std::string workers_string = "worker_jobs: [";
+  if (!statistics.worker_jobs_counts.empty()) {
+    for (const auto jobs_count : statistics.worker_jobs_counts) {
+      workers_string += std::to_string(jobs_count) + ", ";
+    }
+    workers_string.pop_back();
+    workers_string.pop_back();
+  }
+  workers_string += "]";
+
+  return "{\n\tbatch_time: " + print_milliseconds(statistics.batch_time) +
+         ",\n\t" + phases_string + "\n\t" + waits_string + "\n\t" +
+         throughput_string + "\n\t" + workers_string + "\n}";
+}
+
+std::string print_file_writing_statistics(
+    const FileWritingStage::Statistics& statistics) {
+  return "{\n\tfiles: " + std::to_string(statistics.files_count) +
+         ",\n\twritten_bytes: " + std::to_string(statistics.written_bytes) +
+         ",\n\twrite_time: " + print_milliseconds(statistics.write_time) +
+         ",\n\tbytes_per_second: " +
+         std::to_string(static_cast<long long>(statistics.bytes_per_second)) +
+         ",\n\tqueue: {depth: " + std::to_string(statistics.queue_depth) +
+         ", max_depth: " + std::to_string(statistics.max_queue_depth) +
+         ", bytes: " + std::to_string(statistics.queued_bytes) + "}\n}";
+}
 }  // namespace printing
 }  // namespace uni_course_cpp
@@ -1,14 +1,33 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include "cancellation_token.hpp"
+#include "file_writing_stage.hpp"
+#include "generation_statistics.hpp"
 #include "graph.hpp"
+#include "graph_summary.hpp"
+#include "perf_counters.hpp"
 
 namespace uni_course_cpp {
 namespace printing {
 std::string print_depth_info(Graph::Depth depth);
 std::string print_edges_info(const Graph& graph);
+std::string print_edges_info(const GraphSummary& summary);
+// The names used in every output format
+std::string_view get_edge_color_name(Graph::Edge::Color color);
 std::string print_edge_color(Graph::Edge::Color color);
 std::string print_vertices_info(const Graph& graph);
-std::string print_graph(const Graph& graph);
+std::string print_vertices_info(const GraphSummary& summary);
+std::string print_memory_usage(const Graph::MemoryUsage& memory_usage);
+std::string print_graph(const Graph& graph, bool with_memory_usage = false);
+std::string print_graph(const GraphSummary& summary);
+std::string print_generation_status(GenerationStatus status);
+std::string print_generation_phase(GenerationPhase phase);
+std::string print_perf_counters(const perf::Values& values);
+std::string print_generation_statistics(
+    const GenerationStatistics::Snapshot& statistics);
+std::string print_file_writing_statistics(
+    const FileWritingStage::Statistics& statistics);
 }  // namespace printing
 }  // namespace uni_course_cpp
@@ -0,0 +1,28 @@
+#include "graph_summary.hpp"
+
+namespace uni_course_cpp {
+GraphSummary get_graph_summary(const Graph& graph, bool with_memory_usage) {
+  auto summary = GraphSummary();
+  summary.depth = graph.get_depth();
+  summary.vertices_count = graph.get_vertices().size();
+  summary.edges_count = graph.get_edges().size();
+
+  summary.depth_vertices_counts.reserve(summary.depth + 1);
+  for (Graph::Depth depth = 0; depth <= summary.depth; depth++) {
+    summary.depth_vertices_counts.push_back(
+        graph.get_depth_vertex_ids(depth).size());
+  }
+
+  for (int color = 0; color < Graph::Edge::kColorsCount; color++) {
+    summary.color_edges_counts[color] =
+        graph.get_color_edge_ids(static_cast<Graph::Edge::Color>(color))
+            .size();
+  }
+
+  if (with_memory_usage) {
+    summary.memory_usage = graph.get_memory_usage();
+  }
+
+  return summary;
+}
+}  // namespace uni_course_cpp
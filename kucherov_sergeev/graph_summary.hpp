@@ -0,0 +1,26 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace uni_course_cpp {
+// The counts the graph description is printed from, small enough to be
+// logged instead of the description itself
+struct GraphSummary {
+  Graph::Depth depth = 0;
+  int vertices_count = 0;
+  int edges_count = 0;
+  // Vertices of every depth from zero to the graph depth
+  std::vector<int> depth_vertices_counts;
+  // Indexed by the edge color
+  std::array<int, Graph::Edge::kColorsCount> color_edges_counts = {};
+  // Only on request, it takes a pass over the graph
+  std::optional<Graph::MemoryUsage> memory_usage;
+};
+
+GraphSummary get_graph_summary(const Graph& graph,
+                               bool with_memory_usage = false);
+}  // namespace uni_course_cpp
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace uni_course_cpp {
+namespace printing {
+namespace json {
+// Pretty matches the original printer, one element per line indented with
+// tabs. Compact has no whitespace at all.
+enum class Style { Pretty, Compact };
+
+// Character array built at compile time
+template <std::size_t Size>
+struct Literal {
+  std::array<char, Size> characters = {};
+
+  static constexpr std::size_t size() { return Size; }
+  constexpr std::string_view view() const {
+    return std::string_view(characters.data(), Size);
+  }
+};
+
+template <std::size_t Size>
+constexpr Literal<Size - 1> make_literal(const char (&string)[Size]) {
+  auto literal = Literal<Size - 1>();
+  for (std::size_t i = 0; i + 1 < Size; i++) {
+    literal.characters[i] = string[i];
+  }
+  return literal;
+}
+
+template <std::size_t Size, std::size_t ResultSize>
+constexpr void append_literal(Literal<ResultSize>& result,
+                              std::size_t& position,
+                              const Literal<Size>& literal) {
+  for (std::size_t i = 0; i < Size; i++) {
+    result.characters[position++] = literal.characters[i];
+  }
+}
+
+template <std::size_t... Sizes>
+constexpr Literal<(Sizes + ... + 0)> concat(const Literal<Sizes>&... literals) {
+  auto result = Literal<(Sizes + ... + 0)>();
+  std::size_t position = 0;
+  (append_literal(result, position, literals), ...);
+  return result;
+}
+
+template <Style style>
+constexpr auto make_new_line() {
+  if constexpr (style == Style::Pretty) {
+    return make_literal("\n");
+  } else {
+    return Literal<0>();
+  }
+}
+
+template <Style style, std::size_t Level>
+constexpr auto make_indent() {
+  if constexpr (style == Style::Pretty) {
+    auto indent = Literal<Level>();
+    for (std::size_t i = 0; i < Level; i++) {
+      indent.characters[i] = '\t';
+    }
+    return indent;
+  } else {
+    return Literal<0>();
+  }
+}
+
+template <Style style>
+constexpr auto make_space() {
+  if constexpr (style == Style::Pretty) {
+    return make_literal(" ");
+  } else {
+    return Literal<0>();
+  }
+}
+
+template <std::size_t Size>
+constexpr auto make_key(const Literal<Size>& name) {
+  return concat(make_literal("\""), name, make_literal("\":"));
+}
+
+// Vertices and edges take a single line in both styles. Every constant is
+// the literal text written before the value it is named after.
+struct VertexLayout {
+  static constexpr auto kId =
+      concat(make_literal("{"), make_key(make_literal("id")));
+  static constexpr auto kEdgeIds =
+      concat(make_literal(","), make_key(make_literal("edge_ids")),
+             make_literal("["));
+  static constexpr auto kEdgeIdsSeparator = make_literal(",");
+  static constexpr auto kDepth = concat(
+      make_literal("]"), make_literal(","), make_key(make_literal("depth")));
+  static constexpr auto kEnd = make_literal("}");
+};
+
+struct EdgeLayout {
+  static constexpr auto kId =
+      concat(make_literal("{"), make_key(make_literal("id")));
+  static constexpr auto kVertexIds =
+      concat(make_literal(","), make_key(make_literal("vertex_ids")),
+             make_literal("["));
+  static constexpr auto kVertexIdsSeparator = make_literal(",");
+  static constexpr auto kColor =
+      concat(make_literal("]"), make_literal(","),
+             make_key(make_literal("color")), make_literal("\""));
+  static constexpr auto kEnd = make_literal("\"}");
+};
+
+template <Style style>
+struct GraphLayout {
+  static constexpr auto kNewLine = make_new_line<style>();
+  static constexpr auto kFieldIndent = make_indent<style, 1>();
+  static constexpr auto kElementIndent = make_indent<style, 2>();
+  // The original printer has a space before the vertices array only
+  static constexpr auto kVerticesSpace = make_space<style>();
+
+  static constexpr auto kDepth =
+      concat(make_literal("{"), kNewLine, kFieldIndent,
+             make_key(make_literal("depth")));
+  static constexpr auto kVertices =
+      concat(make_literal(","), kNewLine, kFieldIndent,
+             make_key(make_literal("vertices")), kVerticesSpace,
+             make_literal("["), kNewLine);
+  static constexpr auto kFirstElement = kElementIndent;
+  static constexpr auto kNextElement =
+      concat(make_literal(","), kNewLine, kElementIndent);
+  static constexpr auto kEdges =
+      concat(kNewLine, kFieldIndent, make_literal("],"), kNewLine,
+             kFieldIndent, make_key(make_literal("edges")), make_literal("["),
+             kNewLine);
+  static constexpr auto kEnd = concat(kNewLine, kFieldIndent, make_literal("]"),
+                                      kNewLine, make_literal("}"), kNewLine);
+};
+
+// The graph layout of a style chosen at runtime
+struct GraphFragments {
+  std::string_view depth;
+  std::string_view vertices;
+  std::string_view first_element;
+  std::string_view next_element;
+  std::string_view edges;
+  std::string_view end;
+};
+
+template <Style style>
+inline constexpr GraphFragments kGraphFragments = {
+    GraphLayout<style>::kDepth.view(),
+    GraphLayout<style>::kVertices.view(),
+    GraphLayout<style>::kFirstElement.view(),
+    GraphLayout<style>::kNextElement.view(),
+    GraphLayout<style>::kEdges.view(),
+    GraphLayout<style>::kEnd.view()};
+
+constexpr const GraphFragments& get_graph_fragments(Style style) {
+  return style == Style::Pretty ? kGraphFragments<Style::Pretty>
+                                : kGraphFragments<Style::Compact>;
+}
+}  // namespace json
+}  // namespace printing
+}  // namespace uni_course_cpp
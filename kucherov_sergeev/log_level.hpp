@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string_view>
+
+// Log calls below the minimum level are compiled out, build with
+// -DUNI_COURSE_CPP_MIN_LOG_LEVEL=0 to keep the trace logs
+#ifndef UNI_COURSE_CPP_MIN_LOG_LEVEL
+#define UNI_COURSE_CPP_MIN_LOG_LEVEL 2
+#endif
+
+namespace uni_course_cpp {
+enum class LogLevel { Trace, Debug, Info, Warning, Error };
+
+inline constexpr auto kMinLogLevel =
+    static_cast<LogLevel>(UNI_COURSE_CPP_MIN_LOG_LEVEL);
+
+constexpr std::string_view get_log_level_name(LogLevel level) {
+  switch (level) {
+    case LogLevel::Trace:
+      return "TRACE";
+    case LogLevel::Debug:
+      return "DEBUG";
+    case LogLevel::Info:
+      return "INFO";
+    case LogLevel::Warning:
+      return "WARNING";
+    case LogLevel::Error:
+      return "ERROR";
+  }
+  return "UNKNOWN";
+}
+}  // namespace uni_course_cpp
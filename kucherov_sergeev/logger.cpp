@@ -1,33 +1,49 @@
-#include <chrono>
-#include <ctime>
-#include <iomanip>
 #include <iostream>
-#include <mutex>
-#include <sstream>
 #include <stdexcept>
 
 #include "config.hpp"
 #include "logger.hpp"
 
-namespace {
-std::string get_current_date_time() {
-  const auto date_time = std::chrono::system_clock::now();
-  const auto date_time_t = std::chrono::system_clock::to_time_t(date_time);
-  std::stringstream date_time_string;
-  date_time_string << std::put_time(std::localtime(&date_time_t),
-                                    "%Y.%m.%d %H:%M:%S");
-  return date_time_string.str();
+namespace uni_course_cpp {
+void Logger::log(LogLevel level, std::string string) {
+  if (!is_enabled(level)) {
+    return;
+  }
+
+  auto record = Record{TimestampFormatter::now(config::kLogTimestampClock),
+                       level, std::move(string)};
+
+  while (!records_.try_push(std::move(record))) {
+    if (overflow_policy_ == OverflowPolicy::Drop) {
+      dropped_count_++;
+      return;
+    }
+    std::this_thread::yield();
+  }
 }
-}  // namespace
 
-namespace uni_course_cpp {
-void Logger::log(const std::string& string) {
-  const auto log_string = get_current_date_time() + " " + string;
+void Logger::flush() {
+  const auto pushed_count = records_.get_pushed_count();
 
-  const std::lock_guard lock(logger_mutex_);
+  auto lock = std::unique_lock(writer_mutex_);
+  flush_requests_count_++;
+  writer_wakeup_.notify_one();
+  written_.wait(lock, [this, pushed_count]() {
+    return written_count_ >= pushed_count;
+  });
+  flush_requests_count_--;
+}
+
+void Logger::set_level(LogLevel level) {
+  level_ = level;
+}
+
+void Logger::set_overflow_policy(OverflowPolicy overflow_policy) {
+  overflow_policy_ = overflow_policy;
+}
 
-  std::cout << log_string << std::endl;
-  log_file_ << log_string << std::endl;
+std::size_t Logger::get_dropped_count() const {
+  return dropped_count_;
 }
 
 Logger& Logger::get_logger() {
@@ -36,9 +52,77 @@ Logger& Logger::get_logger() {
   return logger;
 };
 
-Logger::Logger() : log_file_(config::kLogFilePath) {
+Logger::Logger()
+    : log_file_(config::kLogFilePath), records_(config::kLogQueueCapacity) {
   if (!log_file_.is_open()) {
     throw std::runtime_error("Failed to create file stream");
   }
+
+  writer_thread_ = std::thread([this]() { run_writer(); });
 };
+
+Logger::~Logger() {
+  {
+    const std::lock_guard lock(writer_mutex_);
+    is_stopping_ = true;
+  }
+  writer_wakeup_.notify_one();
+  writer_thread_.join();
+}
+
+void Logger::run_writer() {
+  std::string batch;
+  std::size_t reported_dropped_count = 0;
+  auto record = Record();
+  auto timestamp_formatter = TimestampFormatter(
+      config::kLogTimestampClock, config::kLogTimestampResolution);
+
+  while (true) {
+    std::size_t batch_size = 0;
+    batch.clear();
+    while (batch_size < config::kLogQueueCapacity &&
+           records_.try_pop(record)) {
+      batch += timestamp_formatter.format(record.time);
+      batch += ' ';
+      batch += get_log_level_name(record.level);
+      batch += ' ';
+      batch += record.message;
+      batch += '\n';
+      batch_size++;
+    }
+
+    const std::size_t dropped_count = dropped_count_;
+    if (dropped_count != reported_dropped_count) {
+      batch += timestamp_formatter.format(
+          TimestampFormatter::now(config::kLogTimestampClock));
+      batch += ' ';
+      batch += get_log_level_name(LogLevel::Warning);
+      batch += " " + std::to_string(dropped_count - reported_dropped_count) +
+               " log messages dropped\n";
+      reported_dropped_count = dropped_count;
+    }
+
+    if (!batch.empty()) {
+      std::cout.write(batch.data(), batch.size());
+      std::cout.flush();
+      log_file_.write(batch.data(), batch.size());
+      log_file_.flush();
+    }
+
+    auto lock = std::unique_lock(writer_mutex_);
+    written_count_ += batch_size;
+    written_.notify_all();
+    if (batch_size != 0) {
+      continue;
+    }
+    if (is_stopping_ && records_.get_pushed_count() == written_count_) {
+      return;
+    }
+    // Producers never notify, so an idle writer polls. A flush request or
+    // the shutdown wakes it immediately.
+    writer_wakeup_.wait_for(lock, config::kLogFlushInterval, [this]() {
+      return is_stopping_ || flush_requests_count_ != 0;
+    });
+  }
+}
 }  // namespace uni_course_cpp
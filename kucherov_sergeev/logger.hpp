@@ -1,14 +1,62 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <fstream>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "log_level.hpp"
+#include "mpsc_queue.hpp"
+#include "timestamp.hpp"
 
 namespace uni_course_cpp {
+// log() only stamps the message and pushes it to a lock-free queue. A
+// background thread formats the queued messages and writes them to the
+// console and the log file in batches, flushing once per batch.
+//
+// Messages below the runtime level are dropped before they are queued.
+// The templated log() builds the message only if its level is enabled, and
+// compiles to nothing below kMinLogLevel:
+//   Logger::log<LogLevel::Debug>([&]() { return print_graph(graph); });
 class Logger {
  public:
+  enum class OverflowPolicy {
+    // Wait for the writer to free a slot
+    Block,
+    // Drop the message, the writer reports the dropped count
+    Drop
+  };
+
   static Logger& get_logger();
 
-  void log(const std::string& string);
+  void log(LogLevel level, std::string string);
+  void log(std::string string) { log(LogLevel::Info, std::move(string)); }
+
+  // Static, so a call below kMinLogLevel doesn't even create the logger
+  template <LogLevel level, typename MessageBuilder>
+  static void log(MessageBuilder&& build_message) {
+    if constexpr (level >= kMinLogLevel) {
+      auto& logger = get_logger();
+      if (logger.is_enabled(level)) {
+        logger.log(level, build_message());
+      }
+    }
+  }
+
+  bool is_enabled(LogLevel level) const {
+    return level >= kMinLogLevel && level >= level_;
+  }
+  void set_level(LogLevel level);
+
+  // Waits until everything logged before the call is written
+  void flush();
+
+  void set_overflow_policy(OverflowPolicy overflow_policy);
+  std::size_t get_dropped_count() const;
 
   Logger(const Logger& other) = delete;
   void operator=(const Logger& other) = delete;
@@ -17,10 +65,30 @@ class Logger {
   void operator=(Logger&& other) = delete;
 
  private:
+  struct Record {
+    TimestampFormatter::Duration time;
+    LogLevel level = LogLevel::Info;
+    std::string message;
+  };
+
   Logger();
-  ~Logger() = default;
+  ~Logger();
+
+  void run_writer();
 
   std::ofstream log_file_;
-  std::mutex logger_mutex_;
+  MpscQueue<Record> records_;
+  std::atomic<LogLevel> level_ = LogLevel::Info;
+  std::atomic<OverflowPolicy> overflow_policy_ = OverflowPolicy::Block;
+  std::atomic<std::size_t> dropped_count_ = 0;
+
+  std::mutex writer_mutex_;
+  std::condition_variable writer_wakeup_;
+  std::condition_variable written_;
+  std::size_t written_count_ = 0;
+  std::size_t flush_requests_count_ = 0;
+  bool is_stopping_ = false;
+
+  std::thread writer_thread_;
 };
 }  // namespace uni_course_cpp
@@ -1,27 +1,123 @@
+#include <algorithm>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#include <thread>
 
+#include "buffered_writer.hpp"
 #include "config.hpp"
+#include "event_log.hpp"
+#include "file_writing_stage.hpp"
 #include "graph.hpp"
 #include "graph_generation_controller.hpp"
+#include "graph_binary.hpp"
+#include "graph_compact.hpp"
 #include "graph_generator.hpp"
 #include "graph_json_printing.hpp"
 #include "graph_printing.hpp"
 #include "logger.hpp"
+#include "perf_counters.hpp"
+#include "tracing.hpp"
 
 using Graph = uni_course_cpp::Graph;
 using GraphGenerator = uni_course_cpp::GraphGenerator;
 using Logger = uni_course_cpp::Logger;
 
-void write_to_file(const std::string& graph_json,
-                   const std::string& file_name) {
+// Perf counters of the serializers on the calling thread, the helper threads
+// of the parallel JSON writer aren't counted
+struct SerializationCounters {
+  uni_course_cpp::perf::CounterTotals json;
+  uni_course_cpp::perf::CounterTotals binary;
+  uni_course_cpp::perf::CounterTotals compact;
+};
+
+// Every file writing thread may run a parallel JSON writer at the same
+// time, so the writers share the cores instead of each taking all of them
+int get_json_threads_count() {
+  const int cores_count = std::thread::hardware_concurrency();
+  return std::max(
+      cores_count / uni_course_cpp::config::kFileWritingThreadsCount, 1);
+}
+
+// The serializers run on the file writing threads and share the graph, so
+// the generation workers only pay for queueing them
+void write_to_file(uni_course_cpp::FileWritingStage& file_writing_stage,
+                   const std::shared_ptr<const Graph>& graph,
+                   const std::string& file_name,
+                   uni_course_cpp::perf::CounterTotals& counters) {
   const std::string file_path =
       uni_course_cpp::config::kTempDirectoryPath + file_name;
-  std::ofstream json_file(file_path);
+  const auto order =
+      uni_course_cpp::config::kDeterministicJsonOutput
+          ? uni_course_cpp::printing::json::ElementOrder::Id
+          : uni_course_cpp::printing::json::ElementOrder::Storage;
+  const auto style = uni_course_cpp::config::kCompactJsonOutput
+                         ? uni_course_cpp::printing::json::Style::Compact
+                         : uni_course_cpp::printing::json::Style::Pretty;
+  // Queueing the whole document of a large graph would defeat the bounded
+  // memory of the parallel writer
+  if (graph->get_edges().size() >=
+      uni_course_cpp::config::kParallelJsonMinEdgesCount) {
+    file_writing_stage.enqueue(
+        file_path,
+        uni_course_cpp::FileWritingStage::WriteFileCallback(
+            [graph, order, style, &counters](const std::string& file_path) {
+              const uni_course_cpp::tracing::Span span("Serialize JSON",
+                                                       "output");
+              const uni_course_cpp::perf::Scope counters_scope(&counters);
+              uni_course_cpp::printing::json::write_graph_parallel(
+                  *graph, file_path, get_json_threads_count(), order, style);
+            }));
+    return;
+  }
+
+  file_writing_stage.enqueue(
+      file_path, uni_course_cpp::FileWritingStage::SerializeCallback(
+                     [graph, order, style, &counters]() {
+                       const uni_course_cpp::tracing::Span span(
+                           "Serialize JSON", "output");
+                       const uni_course_cpp::perf::Scope counters_scope(
+                           &counters);
+                       return uni_course_cpp::printing::json::print_graph(
+                           *graph, order, style);
+                     }));
+}
 
-  json_file << graph_json;
+void write_binary_to_file(uni_course_cpp::FileWritingStage& file_writing_stage,
+                          const std::shared_ptr<const Graph>& graph,
+                          const std::string& file_name,
+                          uni_course_cpp::perf::CounterTotals& counters) {
+  file_writing_stage.enqueue(
+      uni_course_cpp::config::kTempDirectoryPath + file_name,
+      uni_course_cpp::FileWritingStage::SerializeCallback([graph,
+                                                           &counters]() {
+        const uni_course_cpp::tracing::Span span("Serialize Binary", "output");
+        const uni_course_cpp::perf::Scope counters_scope(&counters);
+        std::string graph_binary;
+        {
+          auto writer = uni_course_cpp::StringWriter(graph_binary);
+          uni_course_cpp::binary::write_graph(*graph, writer);
+        }
+        return graph_binary;
+      }));
+}
+
+void write_compact_to_file(
+    uni_course_cpp::FileWritingStage& file_writing_stage,
+    const std::shared_ptr<const Graph>& graph,
+    const std::string& file_name,
+    uni_course_cpp::perf::CounterTotals& counters) {
+  file_writing_stage.enqueue(
+      uni_course_cpp::config::kTempDirectoryPath + file_name,
+      uni_course_cpp::FileWritingStage::SerializeCallback([graph,
+                                                           &counters]() {
+        const uni_course_cpp::tracing::Span span("Serialize Compact",
+                                                 "output");
+        const uni_course_cpp::perf::Scope counters_scope(&counters);
+        return uni_course_cpp::compact::encode_graph(*graph);
+      }));
 }
 
 int handle_depth_input() {
@@ -131,6 +227,55 @@ std::string generation_finished_string(int graph_number,
          graph_description;
 }
 
+std::string generation_truncated_string(int graph_number,
+                                        uni_course_cpp::GenerationStatus status,
+                                        const std::string& graph_description) {
+  return "Graph " + std::to_string(graph_number) + ", Generation Truncated (" +
+         uni_course_cpp::printing::print_generation_status(status) + ") " +
+         graph_description;
+}
+
+std::string duplicate_skipped_string(int graph_number) {
+  return "Graph " + std::to_string(graph_number) +
+         ", Duplicate, Writing Skipped";
+}
+
+std::string batch_truncated_string(uni_course_cpp::GenerationStatus status) {
+  return "Generation Truncated (" +
+         uni_course_cpp::printing::print_generation_status(status) + ")";
+}
+
+std::string file_writing_statistics_string(
+    const uni_course_cpp::FileWritingStage& file_writing_stage) {
+  return "File Writing Statistics " +
+         uni_course_cpp::printing::print_file_writing_statistics(
+             file_writing_stage.get_statistics());
+}
+
+std::string unique_graphs_string(int unique_graphs_count, int graphs_count) {
+  return "Unique Graphs " + std::to_string(unique_graphs_count) + " of " +
+         std::to_string(graphs_count);
+}
+
+std::string generation_statistics_string(
+    const uni_course_cpp::GraphGenerationController& generation_controller) {
+  return "Generation Statistics " +
+         uni_course_cpp::printing::print_generation_statistics(
+             generation_controller.get_statistics());
+}
+
+std::string serialization_counters_string(
+    const SerializationCounters& counters) {
+  return "Serialization Counters {\n\tjson: " +
+         uni_course_cpp::printing::print_perf_counters(counters.json.get()) +
+         ",\n\tbinary: " +
+         uni_course_cpp::printing::print_perf_counters(counters.binary.get()) +
+         ",\n\tcompact: " +
+         uni_course_cpp::printing::print_perf_counters(
+             counters.compact.get()) +
+         "\n}";
+}
+
 void prepare_temp_directory() {
   if (std::filesystem::exists(uni_course_cpp::config::kTempDirectoryPath) ==
       false) {
@@ -146,23 +291,124 @@ std::vector<Graph> generate_graphs(GraphGenerator::Params&& params,
                                    int threads_count) {
   auto generation_controller = uni_course_cpp::GraphGenerationController(
       threads_count, graphs_count, std::move(params));
-
+  if (uni_course_cpp::config::kGraphGenerationTimeout.has_value()) {
+    generation_controller.set_graph_timeout(
+        uni_course_cpp::config::kGraphGenerationTimeout.value());
+  }
+  generation_controller.set_statistics_enabled(true);
+  generation_controller.set_deduplication_enabled(
+      uni_course_cpp::config::kDeduplicateGraphs);
+
+  uni_course_cpp::tracing::set_enabled(
+      uni_course_cpp::config::kTracingEnabled);
+  uni_course_cpp::perf::set_enabled(
+      uni_course_cpp::config::kPerfCountersEnabled);
   auto& logger = Logger::get_logger();
+  logger.set_level(uni_course_cpp::config::kLogLevel);
+  // Graphs are serialized on the file writing threads, so they get at least
+  // as many threads as the generation
+  auto file_writing_stage = uni_course_cpp::FileWritingStage(std::max(
+      uni_course_cpp::config::kFileWritingThreadsCount, threads_count));
 
   auto graphs = std::vector<Graph>();
   graphs.reserve(graphs_count);
+  auto serialization_counters = SerializationCounters();
 
-  generation_controller.generate(
-      [&logger](int index) { logger.log(generation_started_string(index)); },
-      [&logger, &graphs](int index, Graph&& graph) {
+  auto event_log = std::optional<uni_course_cpp::event_log::EventLogWriter>();
+  if (uni_course_cpp::config::kStructuredLogging) {
+    event_log.emplace(uni_course_cpp::config::kEventLogFilePath,
+                      uni_course_cpp::config::kLogTimestampClock);
+  }
+  // The callbacks are serialized by the controller
+  auto start_times =
+      std::vector<uni_course_cpp::TimestampFormatter::Duration>(graphs_count);
+
+  const auto status = generation_controller.generate(
+      [&logger, &event_log, &start_times](int index) {
+        if (event_log) {
+          start_times[index] =
+              uni_course_cpp::TimestampFormatter::now(event_log->get_clock());
+          event_log->log_generation_started(index);
+          return;
+        }
+        logger.log(generation_started_string(index));
+      },
+      [&event_log, &start_times, &graphs, &file_writing_stage,
+       &serialization_counters](
+          int index, Graph&& finished_graph,
+          uni_course_cpp::GenerationStatus status, bool is_duplicate) {
+        const auto shared_graph =
+            std::make_shared<const Graph>(std::move(finished_graph));
+        const auto& graph = *shared_graph;
         graphs.push_back(graph);
-        const auto graph_description =
-            uni_course_cpp::printing::print_graph(graph);
-        logger.log(generation_finished_string(index, graph_description));
-        const auto graph_json =
-            uni_course_cpp::printing::json::print_graph(graph);
-        write_to_file(graph_json, "graph_" + std::to_string(index) + ".json");
+        if (event_log) {
+          const auto duration =
+              uni_course_cpp::TimestampFormatter::now(event_log->get_clock()) -
+              start_times[index];
+          event_log->log_generation_finished(index, status, duration, graph);
+        } else {
+          if (status == uni_course_cpp::GenerationStatus::Completed) {
+            Logger::log<uni_course_cpp::LogLevel::Info>([index, &graph]() {
+              return generation_finished_string(
+                  index,
+                  uni_course_cpp::printing::print_graph(
+                      graph, uni_course_cpp::config::kLogGraphMemoryUsage));
+            });
+          } else {
+            Logger::log<uni_course_cpp::LogLevel::Warning>(
+                [index, status, &graph]() {
+                  return generation_truncated_string(
+                      index, status,
+                      uni_course_cpp::printing::print_graph(
+                          graph, uni_course_cpp::config::kLogGraphMemoryUsage));
+                });
+          }
+        }
+        if (is_duplicate) {
+          Logger::log<uni_course_cpp::LogLevel::Info>([index]() {
+            return duplicate_skipped_string(index);
+          });
+          return;
+        }
+        write_to_file(file_writing_stage, shared_graph,
+                      "graph_" + std::to_string(index) + ".json",
+                      serialization_counters.json);
+        if (uni_course_cpp::config::kWriteBinaryGraphs) {
+          write_binary_to_file(file_writing_stage, shared_graph,
+                               "graph_" + std::to_string(index) + ".bin",
+                               serialization_counters.binary);
+        }
+        if (uni_course_cpp::config::kWriteCompactGraphs) {
+          write_compact_to_file(file_writing_stage, shared_graph,
+                                "graph_" + std::to_string(index) + ".ucgc",
+                                serialization_counters.compact);
+        }
       });
+  if (event_log) {
+    event_log->flush();
+  }
+
+  if (status != uni_course_cpp::GenerationStatus::Completed) {
+    logger.log(uni_course_cpp::LogLevel::Warning,
+               batch_truncated_string(status));
+  }
+
+  if (uni_course_cpp::config::kDeduplicateGraphs) {
+    logger.log(unique_graphs_string(
+        generation_controller.get_unique_graphs_count(), graphs_count));
+  }
+  logger.log(generation_statistics_string(generation_controller));
+  if (uni_course_cpp::config::kPerfCountersEnabled) {
+    logger.log(serialization_counters_string(serialization_counters));
+  }
+
+  file_writing_stage.finish();
+  logger.log(file_writing_statistics_string(file_writing_stage));
+
+  if (uni_course_cpp::config::kTracingEnabled) {
+    uni_course_cpp::tracing::write_chrome_trace(
+        uni_course_cpp::config::kTraceFilePath);
+  }
 
   return graphs;
 }
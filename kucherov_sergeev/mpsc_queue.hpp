@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace uni_course_cpp {
+// Bounded lock-free queue for many producers and a single consumer. Every
+// cell carries a sequence number telling whose turn it is, so producers
+// only race for the enqueue position and never wait for each other.
+template <typename T>
+class MpscQueue {
+ public:
+  // The capacity is rounded up to a power of two
+  explicit MpscQueue(std::size_t capacity)
+      : capacity_(get_power_of_two(capacity)),
+        cells_(std::make_unique<Cell[]>(capacity_)) {
+    for (std::size_t i = 0; i < capacity_; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscQueue(const MpscQueue& other) = delete;
+  void operator=(const MpscQueue& other) = delete;
+
+  // Returns false if the queue is full
+  bool try_push(T&& value) {
+    auto position = enqueue_position_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    while (true) {
+      cell = &cells_[position & (capacity_ - 1)];
+      const auto sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::intptr_t>(sequence) -
+                              static_cast<std::intptr_t>(position);
+      if (difference == 0) {
+        if (enqueue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->value = std::move(value);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only, returns false if the queue is empty
+  bool try_pop(T& value) {
+    auto& cell = cells_[dequeue_position_ & (capacity_ - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) !=
+        dequeue_position_ + 1) {
+      return false;
+    }
+
+    value = std::move(cell.value);
+    cell.sequence.store(dequeue_position_ + capacity_,
+                        std::memory_order_release);
+    dequeue_position_++;
+    return true;
+  }
+
+  // Values pushed or being pushed so far
+  std::size_t get_pushed_count() const {
+    return enqueue_position_.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> sequence = 0;
+    T value;
+  };
+
+  static std::size_t get_power_of_two(std::size_t value) {
+    std::size_t power_of_two = 1;
+    while (power_of_two < value) {
+      power_of_two <<= 1;
+    }
+    return power_of_two;
+  }
+
+  const std::size_t capacity_;
+  std::unique_ptr<Cell[]> cells_;
+  alignas(64) std::atomic<std::size_t> enqueue_position_ = 0;
+  alignas(64) std::size_t dequeue_position_ = 0;
+};
+}  // namespace uni_course_cpp
@@ -0,0 +1,157 @@
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+#include "perf_counters.hpp"
+
+namespace uni_course_cpp {
+namespace perf {
+namespace {
+std::atomic<bool> is_enabled_ = false;
+
+#if defined(__linux__)
+constexpr std::array<std::uint64_t, kCountersCount> kCounterConfigs = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+int open_counter(std::uint64_t config) {
+  perf_event_attr attributes;
+  std::memset(&attributes, 0, sizeof(attributes));
+  attributes.size = sizeof(attributes);
+  attributes.type = PERF_TYPE_HARDWARE;
+  attributes.config = config;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  // Counters opened one by one may be multiplexed, the times let the reads
+  // be scaled to the whole period
+  attributes.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+
+class ThreadCounters {
+ public:
+  ThreadCounters() {
+    for (int i = 0; i < kCountersCount; i++) {
+      file_descriptors_[i] = open_counter(kCounterConfigs[i]);
+    }
+  }
+
+  ~ThreadCounters() {
+    for (const auto file_descriptor : file_descriptors_) {
+      if (file_descriptor >= 0) {
+        ::close(file_descriptor);
+      }
+    }
+  }
+
+  ThreadCounters(const ThreadCounters& other) = delete;
+  void operator=(const ThreadCounters& other) = delete;
+
+  Values read() const {
+    auto values = kUnavailableValues;
+    for (int i = 0; i < kCountersCount; i++) {
+      values[i] = read_counter(file_descriptors_[i]);
+    }
+    return values;
+  }
+
+ private:
+  static std::int64_t read_counter(int file_descriptor) {
+    if (file_descriptor < 0) {
+      return kUnavailable;
+    }
+    struct {
+      std::uint64_t value;
+      std::uint64_t time_enabled;
+      std::uint64_t time_running;
+    } result;
+    if (::read(file_descriptor, &result, sizeof(result)) !=
+            static_cast<ssize_t>(sizeof(result)) ||
+        result.time_running == 0) {
+      return kUnavailable;
+    }
+    if (result.time_running == result.time_enabled) {
+      return static_cast<std::int64_t>(result.value);
+    }
+    return static_cast<std::int64_t>(static_cast<double>(result.value) *
+                                     result.time_enabled /
+                                     result.time_running);
+  }
+
+  std::array<int, kCountersCount> file_descriptors_ = {};
+};
+#endif
+}  // namespace
+
+void set_enabled(bool is_enabled) {
+  is_enabled_.store(is_enabled, std::memory_order_relaxed);
+}
+
+bool is_enabled() {
+  return is_enabled_.load(std::memory_order_relaxed);
+}
+
+Values read_thread_counters() {
+#if defined(__linux__)
+  thread_local const ThreadCounters thread_counters;
+  return thread_counters.read();
+#else
+  return kUnavailableValues;
+#endif
+}
+
+Values get_difference(const Values& end, const Values& start) {
+  auto difference = kUnavailableValues;
+  for (int i = 0; i < kCountersCount; i++) {
+    if (end[i] != kUnavailable && start[i] != kUnavailable) {
+      difference[i] = end[i] - start[i];
+    }
+  }
+  return difference;
+}
+
+void CounterTotals::add(const Values& values) {
+  for (int i = 0; i < kCountersCount; i++) {
+    if (values[i] != kUnavailable) {
+      sums_[i].fetch_add(values[i], std::memory_order_relaxed);
+      is_measured_[i].store(true, std::memory_order_relaxed);
+    }
+  }
+}
+
+Values CounterTotals::get() const {
+  auto values = kUnavailableValues;
+  for (int i = 0; i < kCountersCount; i++) {
+    if (is_measured_[i].load(std::memory_order_relaxed)) {
+      values[i] = sums_[i].load(std::memory_order_relaxed);
+    }
+  }
+  return values;
+}
+
+void CounterTotals::reset() {
+  for (int i = 0; i < kCountersCount; i++) {
+    sums_[i].store(0, std::memory_order_relaxed);
+    is_measured_[i].store(false, std::memory_order_relaxed);
+  }
+}
+
+Scope::Scope(CounterTotals* totals)
+    : totals_(is_enabled() ? totals : nullptr) {
+  if (totals_ != nullptr) {
+    start_values_ = read_thread_counters();
+  }
+}
+
+Scope::~Scope() {
+  if (totals_ != nullptr) {
+    totals_->add(get_difference(read_thread_counters(), start_values_));
+  }
+}
+}  // namespace perf
+}  // namespace uni_course_cpp
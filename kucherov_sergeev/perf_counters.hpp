@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace uni_course_cpp {
+namespace perf {
+// Hardware counters of the calling thread read with perf_event_open. The
+// kernel may refuse any of them (no PMU in a VM, perf_event_paranoid, not
+// Linux), such counters read as kUnavailable and everything else goes on.
+enum class Counter { Cycles, Instructions, CacheMisses, BranchMisses };
+inline constexpr int kCountersCount = 4;
+inline constexpr std::int64_t kUnavailable = -1;
+
+using Values = std::array<std::int64_t, kCountersCount>;
+
+inline constexpr Values kUnavailableValues = {kUnavailable, kUnavailable,
+                                              kUnavailable, kUnavailable};
+
+// Disabled by default, a disabled scope costs a single relaxed atomic load
+void set_enabled(bool is_enabled);
+bool is_enabled();
+
+// Counts since the calling thread first read them. The counters are opened
+// on the first read and closed when the thread exits.
+Values read_thread_counters();
+
+// Difference of each counter, unavailable if either value is
+Values get_difference(const Values& end, const Values& start);
+
+// Thread-safe sums of the counters of many scopes
+class CounterTotals {
+ public:
+  void add(const Values& values);
+  // kUnavailable for counters which were never measured
+  Values get() const;
+  void reset();
+
+ private:
+  std::array<std::atomic<std::int64_t>, kCountersCount> sums_ = {};
+  std::array<std::atomic<bool>, kCountersCount> is_measured_ = {};
+};
+
+// Adds the counts of the calling thread until destruction to the totals.
+// Does nothing without totals or while disabled.
+class Scope {
+ public:
+  explicit Scope(CounterTotals* totals);
+  ~Scope();
+
+  Scope(const Scope& other) = delete;
+  void operator=(const Scope& other) = delete;
+
+ private:
+  CounterTotals* totals_;
+  Values start_values_ = kUnavailableValues;
+};
+}  // namespace perf
+}  // namespace uni_course_cpp
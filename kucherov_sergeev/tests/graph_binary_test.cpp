@@ -0,0 +1,173 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "../graph.hpp"
+#include "../graph_binary.hpp"
+#include "../graph_generator.hpp"
+#include "graph_checks.hpp"
+
+using Graph = uni_course_cpp::Graph;
+using GraphGenerator = uni_course_cpp::GraphGenerator;
+using MappedGraph = uni_course_cpp::binary::MappedGraph;
+using tests::check;
+
+namespace {
+constexpr GraphGenerator::Seed kSeed = 20240917;
+constexpr Graph::Depth kDepth = 6;
+constexpr int kNewVerticesCount = 4;
+constexpr std::size_t kSectionAlignment = 8;
+
+std::string get_file_path(const std::string& file_name) {
+  return (std::filesystem::temp_directory_path() / file_name).string();
+}
+
+std::size_t align_size(std::size_t size) {
+  return (size + kSectionAlignment - 1) / kSectionAlignment *
+         kSectionAlignment;
+}
+
+// Overwrites the bytes of the file at the offset with the value
+template <typename T>
+void patch_file(const std::string& file_path, std::size_t offset, T value) {
+  auto file = std::fstream(file_path,
+                           std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(offset);
+  file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename Operation>
+bool is_throwing(const Operation& operation) {
+  try {
+    operation();
+  } catch (const std::exception&) {
+    return true;
+  }
+  return false;
+}
+
+void check_equal(const Graph& graph, const MappedGraph& mapped_graph) {
+  check(mapped_graph.get_depth() == graph.get_depth() &&
+            mapped_graph.get_vertices_count() == graph.get_vertices().size() &&
+            mapped_graph.get_edges_count() == graph.get_edges().size(),
+        "Mapped graph has different sizes");
+
+  for (Graph::Depth depth = 0; depth <= graph.get_depth(); depth++) {
+    const auto& vertex_ids = graph.get_depth_vertex_ids(depth);
+    const auto mapped_vertex_ids = mapped_graph.get_depth_vertex_ids(depth);
+    check(Graph::VertexIds(mapped_vertex_ids.begin(),
+                           mapped_vertex_ids.end()) == vertex_ids,
+          "Mapped graph has different vertices of depth " +
+              std::to_string(depth));
+  }
+
+  for (const auto& [vertex_id, vertex] : graph.get_vertices()) {
+    const auto& edge_ids = graph.get_connected_edge_ids(vertex_id);
+    const auto mapped_edge_ids = mapped_graph.get_connected_edge_ids(vertex_id);
+    check(mapped_graph.get_vertex_depth(vertex_id) ==
+                  graph.get_vertex_depth(vertex_id) &&
+              Graph::EdgeIds(mapped_edge_ids.begin(), mapped_edge_ids.end()) ==
+                  edge_ids,
+          "Mapped graph has a different vertex " + std::to_string(vertex_id));
+  }
+
+  for (const auto& [edge_id, edge] : graph.get_edges()) {
+    const auto mapped_edge = mapped_graph.get_edge(edge_id);
+    check(mapped_edge.from_vertex_id() == edge.from_vertex_id() &&
+              mapped_edge.to_vertex_id() == edge.to_vertex_id() &&
+              mapped_edge.color() == edge.color(),
+          "Mapped graph has a different edge " + std::to_string(edge_id));
+  }
+}
+
+Graph generate_graph() {
+  return GraphGenerator(
+             GraphGenerator::Params(kDepth, kNewVerticesCount, kSeed))
+      .generate();
+}
+
+void test_round_trip() {
+  for (const auto& graph : {Graph(), generate_graph()}) {
+    const auto file_path = get_file_path("binary_round_trip.ucgb");
+    uni_course_cpp::binary::write_graph(graph, file_path);
+    {
+      const auto mapped_graph = MappedGraph(file_path);
+      mapped_graph.validate();
+      check_equal(graph, mapped_graph);
+    }
+    std::filesystem::remove(file_path);
+  }
+}
+
+void test_invalid_header() {
+  const auto graph = generate_graph();
+  const auto file_path = get_file_path("binary_invalid_header.ucgb");
+
+  uni_course_cpp::binary::write_graph(graph, file_path);
+  patch_file(file_path, 0, 'X');
+  check(is_throwing([&file_path]() { MappedGraph{file_path}; }),
+        "File with a wrong magic is opened");
+
+  uni_course_cpp::binary::write_graph(graph, file_path);
+  std::filesystem::resize_file(file_path,
+                               std::filesystem::file_size(file_path) / 2);
+  check(is_throwing([&file_path]() { MappedGraph{file_path}; }),
+        "Truncated file is opened");
+
+  std::filesystem::remove(file_path);
+}
+
+// Offsets out of their sections are only found when read or validated
+void test_corrupted_offsets() {
+  const auto graph = generate_graph();
+  const auto file_path = get_file_path("binary_corrupted_offsets.ucgb");
+  const std::size_t vertices_count = graph.get_vertices().size();
+  const auto depth_table_offset = sizeof(uni_course_cpp::binary::Header);
+  const auto adjacency_offsets_offset =
+      align_size(depth_table_offset +
+                 (graph.get_depth() + 2) * sizeof(std::uint32_t)) +
+      2 * align_size(vertices_count * sizeof(std::int32_t));
+
+  uni_course_cpp::binary::write_graph(graph, file_path);
+  patch_file(file_path, depth_table_offset + sizeof(std::uint32_t),
+             std::uint32_t{1} << 31);
+  {
+    const auto mapped_graph = MappedGraph(file_path);
+    check(is_throwing([&mapped_graph]() { mapped_graph.validate(); }),
+          "Corrupted depth table is validated");
+    check(is_throwing(
+              [&mapped_graph]() { mapped_graph.get_depth_vertex_ids(1); }),
+          "Corrupted depth table is read");
+  }
+
+  uni_course_cpp::binary::write_graph(graph, file_path);
+  patch_file(file_path, adjacency_offsets_offset + sizeof(std::uint64_t),
+             std::uint64_t{1} << 40);
+  {
+    const auto mapped_graph = MappedGraph(file_path);
+    check(is_throwing([&mapped_graph]() { mapped_graph.validate(); }),
+          "Corrupted adjacency offsets are validated");
+    check(is_throwing(
+              [&mapped_graph]() { mapped_graph.get_connected_edge_ids(0); }),
+          "Corrupted adjacency offsets are read");
+  }
+
+  std::filesystem::remove(file_path);
+}
+}  // namespace
+
+int main() {
+  try {
+    test_round_trip();
+    test_invalid_header();
+    test_corrupted_offsets();
+  } catch (const std::exception& exception) {
+    std::cerr << "graph_binary_test: " << exception.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "graph_binary_test: OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include "../graph.hpp"
+
+namespace tests {
+inline void check(bool condition, const std::string& message) {
+  if (!condition) {
+    throw std::runtime_error(message);
+  }
+}
+
+// Same vertices, depths, adjacency and edges under the same ids
+inline bool is_equal(const uni_course_cpp::Graph& first,
+                     const uni_course_cpp::Graph& second) {
+  if (first.get_depth() != second.get_depth() ||
+      first.get_vertices().size() != second.get_vertices().size() ||
+      first.get_edges().size() != second.get_edges().size()) {
+    return false;
+  }
+  for (const auto& [vertex_id, vertex] : first.get_vertices()) {
+    if (second.get_vertices().count(vertex_id) == 0 ||
+        first.get_vertex_depth(vertex_id) !=
+            second.get_vertex_depth(vertex_id) ||
+        first.get_connected_edge_ids(vertex_id) !=
+            second.get_connected_edge_ids(vertex_id)) {
+      return false;
+    }
+  }
+  for (const auto& [edge_id, edge] : first.get_edges()) {
+    const auto other_edge = second.get_edges().find(edge_id);
+    if (other_edge == second.get_edges().end()) {
+      return false;
+    }
+    if (edge.from_vertex_id() != other_edge->second.from_vertex_id() ||
+        edge.to_vertex_id() != other_edge->second.to_vertex_id() ||
+        edge.color() != other_edge->second.color()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Checks what every generated graph guarantees, truncated ones included: a
+// grey tree from the only vertex of the first depth, with the other edges
+// joining the depths their colors require
+inline void check_well_formed(const uni_course_cpp::Graph& graph) {
+  using Graph = uni_course_cpp::Graph;
+  constexpr auto kRootDepth = uni_course_cpp::kGraphDefaultDepth;
+  const auto& vertices = graph.get_vertices();
+
+  std::size_t depth_vertices_count = 0;
+  for (Graph::Depth depth = 0; depth <= graph.get_depth(); depth++) {
+    for (const auto vertex_id : graph.get_depth_vertex_ids(depth)) {
+      check(vertices.count(vertex_id) == 1, "Unknown vertex in depth index");
+      check(graph.get_vertex_depth(vertex_id) == depth,
+            "Vertex is indexed at a wrong depth");
+      depth_vertices_count++;
+    }
+  }
+  check(depth_vertices_count == vertices.size(),
+        "Depth index doesn't cover every vertex");
+  check(vertices.empty() || graph.get_depth_vertex_ids(kRootDepth).size() == 1,
+        "Graph has several roots");
+
+  auto grey_parents_counts = std::unordered_map<Graph::VertexId, int>();
+  for (const auto& [edge_id, edge] : graph.get_edges()) {
+    const auto from_vertex_id = edge.from_vertex_id();
+    const auto to_vertex_id = edge.to_vertex_id();
+    check(vertices.count(from_vertex_id) == 1 &&
+              vertices.count(to_vertex_id) == 1,
+          "Edge joins an unknown vertex");
+    for (const auto vertex_id : {from_vertex_id, to_vertex_id}) {
+      const auto& edge_ids = graph.get_connected_edge_ids(vertex_id);
+      check(std::find(edge_ids.begin(), edge_ids.end(), edge_id) !=
+                edge_ids.end(),
+            "Edge is missing from the adjacency of its vertex");
+    }
+
+    const auto depth_difference = graph.get_vertex_depth(to_vertex_id) -
+                                  graph.get_vertex_depth(from_vertex_id);
+    switch (edge.color()) {
+      case Graph::Edge::Color::Grey:
+        check(depth_difference == 1, "Grey edge doesn't go a depth down");
+        grey_parents_counts[to_vertex_id]++;
+        break;
+      case Graph::Edge::Color::Green:
+        check(from_vertex_id == to_vertex_id, "Green edge isn't a loop");
+        break;
+      case Graph::Edge::Color::Yellow:
+        check(depth_difference == 1, "Yellow edge doesn't go a depth down");
+        break;
+      case Graph::Edge::Color::Red:
+        check(depth_difference == 2, "Red edge doesn't go two depths down");
+        break;
+    }
+  }
+
+  for (const auto& [vertex_id, vertex] : vertices) {
+    const auto expected_count =
+        graph.get_vertex_depth(vertex_id) == kRootDepth ? 0 : 1;
+    check(grey_parents_counts[vertex_id] == expected_count,
+          "Vertex isn't joined to the grey tree by exactly one edge");
+  }
+}
+}  // namespace tests
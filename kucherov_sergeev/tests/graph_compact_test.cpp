@@ -0,0 +1,89 @@
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../graph.hpp"
+#include "../graph_compact.hpp"
+#include "../graph_generator.hpp"
+#include "graph_checks.hpp"
+
+using Graph = uni_course_cpp::Graph;
+using GraphGenerator = uni_course_cpp::GraphGenerator;
+using Compression = uni_course_cpp::compact::Compression;
+using tests::check;
+
+namespace {
+constexpr GraphGenerator::Seed kSeed = 20240917;
+constexpr Graph::Depth kDepth = 6;
+constexpr int kNewVerticesCount = 4;
+
+Graph generate_graph(Graph::Depth depth) {
+  return GraphGenerator(GraphGenerator::Params(depth, kNewVerticesCount, kSeed))
+      .generate();
+}
+
+// A single vertex, alone and with a loop
+std::vector<Graph> make_depth_one_graphs() {
+  auto graphs = std::vector<Graph>(2);
+  graphs[0].add_vertex();
+  graphs[1].add_edge(graphs[1].add_vertex(), 0);
+  return graphs;
+}
+
+void check_round_trip(const Graph& graph, const std::string& graph_name) {
+  for (const auto compression : {Compression::None, Compression::Lz}) {
+    const auto data = uni_course_cpp::compact::encode_graph(graph, compression);
+    check(tests::is_equal(uni_course_cpp::compact::decode_graph(data), graph),
+          "Decoded " + graph_name + " differs");
+  }
+
+  const auto file_path =
+      (std::filesystem::temp_directory_path() / "compact_round_trip.ucgc")
+          .string();
+  uni_course_cpp::compact::write_graph(graph, file_path);
+  const auto read_graph = uni_course_cpp::compact::read_graph(file_path);
+  std::filesystem::remove(file_path);
+  check(tests::is_equal(read_graph, graph), "Read " + graph_name + " differs");
+}
+
+void test_round_trip() {
+  check_round_trip(Graph(), "empty graph");
+  for (const auto& graph : make_depth_one_graphs()) {
+    check_round_trip(graph, "graph of depth 1");
+  }
+  check_round_trip(generate_graph(1), "generated graph of depth 1");
+  check_round_trip(generate_graph(kDepth), "generated graph");
+}
+
+void test_truncated_data() {
+  const auto data = uni_course_cpp::compact::encode_graph(
+      generate_graph(kDepth), Compression::Lz);
+  const auto header_size = sizeof(uni_course_cpp::compact::Header);
+  for (const auto size : {std::size_t{0}, header_size, data.size() - 1}) {
+    bool is_thrown = false;
+    try {
+      uni_course_cpp::compact::decode_graph(
+          std::string_view(data).substr(0, size));
+    } catch (const std::runtime_error&) {
+      is_thrown = true;
+    }
+    check(is_thrown,
+          "Data truncated to " + std::to_string(size) + " bytes is decoded");
+  }
+}
+}  // namespace
+
+int main() {
+  try {
+    test_round_trip();
+    test_truncated_data();
+  } catch (const std::exception& exception) {
+    std::cerr << "graph_compact_test: " << exception.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "graph_compact_test: OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../cancellation_token.hpp"
+#include "../graph.hpp"
+#include "../graph_generation_controller.hpp"
+#include "../graph_generator.hpp"
+#include "graph_checks.hpp"
+
+using Graph = uni_course_cpp::Graph;
+using GraphGenerationController = uni_course_cpp::GraphGenerationController;
+using GraphGenerator = uni_course_cpp::GraphGenerator;
+using GenerationStatus = uni_course_cpp::GenerationStatus;
+using tests::check;
+
+namespace {
+constexpr GraphGenerator::Seed kSeed = 20240917;
+constexpr Graph::Depth kDepth = 6;
+constexpr int kNewVerticesCount = 4;
+// Takes far longer than the deadlines below to generate
+constexpr Graph::Depth kLargeDepth = 12;
+constexpr int kLargeNewVerticesCount = 5;
+constexpr int kGraphsCount = 8;
+constexpr auto kGraphTimeout = std::chrono::milliseconds(5);
+constexpr auto kBatchTimeout = std::chrono::milliseconds(20);
+
+struct FinishedGraph {
+  int index = 0;
+  Graph graph;
+  GenerationStatus status = GenerationStatus::Completed;
+};
+
+GraphGenerator::Params make_params() {
+  return GraphGenerator::Params(kLargeDepth, kLargeNewVerticesCount, kSeed);
+}
+
+// Runs the batch, cancel_index graph cancels it once started
+std::pair<GenerationStatus, std::vector<FinishedGraph>> generate(
+    GraphGenerationController& controller,
+    int cancel_index = -1) {
+  auto finished_graphs = std::vector<FinishedGraph>();
+  const auto status = controller.generate(
+      [&controller, cancel_index](int index) {
+        if (index == cancel_index) {
+          controller.cancel();
+        }
+      },
+      [&finished_graphs](int index, Graph&& graph, GenerationStatus status,
+                         bool) {
+        finished_graphs.push_back({index, std::move(graph), status});
+      });
+  return {status, std::move(finished_graphs)};
+}
+
+void check_finished_graphs(const std::vector<FinishedGraph>& finished_graphs,
+                           GenerationStatus expected_status) {
+  for (const auto& finished_graph : finished_graphs) {
+    check(finished_graph.status == expected_status,
+          "Graph " + std::to_string(finished_graph.index) +
+              " has a wrong status");
+    tests::check_well_formed(finished_graph.graph);
+  }
+}
+
+void test_scheduling_modes_give_same_graphs() {
+  const auto generate_graphs = [](int tasks_per_worker) {
+    auto controller = GraphGenerationController(
+        2, kGraphsCount,
+        GraphGenerator::Params(kDepth, kNewVerticesCount, kSeed));
+    controller.set_cooperative_scheduling(tasks_per_worker);
+    auto [status, finished_graphs] = generate(controller);
+    check(status == GenerationStatus::Completed, "Batch isn't completed");
+    std::sort(finished_graphs.begin(), finished_graphs.end(),
+              [](const FinishedGraph& first, const FinishedGraph& second) {
+                return first.index < second.index;
+              });
+    return std::move(finished_graphs);
+  };
+
+  const auto graphs = generate_graphs(0);
+  const auto cooperative_graphs = generate_graphs(3);
+  check(static_cast<int>(graphs.size()) == kGraphsCount &&
+            cooperative_graphs.size() == graphs.size(),
+        "Batch skipped a graph");
+  for (std::size_t i = 0; i < graphs.size(); i++) {
+    check(tests::is_equal(graphs[i].graph, cooperative_graphs[i].graph),
+          "Scheduling modes gave different graphs " + std::to_string(i));
+  }
+}
+
+void test_cancel(int tasks_per_worker) {
+  auto controller = GraphGenerationController(2, kGraphsCount, make_params());
+  controller.set_cooperative_scheduling(tasks_per_worker);
+  const auto [status, finished_graphs] = generate(controller, 0);
+
+  check(status == GenerationStatus::Cancelled, "Batch isn't cancelled");
+  check(!finished_graphs.empty(), "Started graph isn't finished");
+  check(static_cast<int>(finished_graphs.size()) < kGraphsCount,
+        "Cancelled batch generated every graph");
+  check_finished_graphs(finished_graphs, GenerationStatus::Cancelled);
+}
+
+void test_graph_timeout(int tasks_per_worker) {
+  auto controller = GraphGenerationController(2, kGraphsCount, make_params());
+  controller.set_cooperative_scheduling(tasks_per_worker);
+  controller.set_graph_timeout(kGraphTimeout);
+  const auto [status, finished_graphs] = generate(controller);
+
+  check(status == GenerationStatus::DeadlineExceeded,
+        "Batch doesn't report the graph deadline");
+  check(static_cast<int>(finished_graphs.size()) == kGraphsCount,
+        "Graph deadline stopped the batch");
+  check_finished_graphs(finished_graphs, GenerationStatus::DeadlineExceeded);
+}
+
+void test_batch_timeout(int tasks_per_worker) {
+  auto controller = GraphGenerationController(2, kGraphsCount, make_params());
+  controller.set_cooperative_scheduling(tasks_per_worker);
+  controller.set_batch_timeout(kBatchTimeout);
+  const auto [status, finished_graphs] = generate(controller);
+
+  check(status == GenerationStatus::DeadlineExceeded,
+        "Batch doesn't report its deadline");
+  check(static_cast<int>(finished_graphs.size()) < kGraphsCount,
+        "Batch deadline didn't skip any graph");
+  check_finished_graphs(finished_graphs, GenerationStatus::DeadlineExceeded);
+}
+}  // namespace
+
+int main() {
+  try {
+    test_scheduling_modes_give_same_graphs();
+    // One graph at a time per worker, then several interleaved on each
+    for (const int tasks_per_worker : {0, 3}) {
+      test_cancel(tasks_per_worker);
+      test_graph_timeout(tasks_per_worker);
+      test_batch_timeout(tasks_per_worker);
+    }
+  } catch (const std::exception& exception) {
+    std::cerr << "graph_generation_controller_test: " << exception.what()
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << "graph_generation_controller_test: OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,97 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include "../buffered_writer.hpp"
+#include "../cancellation_token.hpp"
+#include "../graph.hpp"
+#include "../graph_generator.hpp"
+#include "../graph_json_printing.hpp"
+#include "graph_checks.hpp"
+
+using Graph = uni_course_cpp::Graph;
+using tests::check;
+using GraphGenerator = uni_course_cpp::GraphGenerator;
+
+namespace {
+constexpr GraphGenerator::Seed kSeed = 20240917;
+constexpr Graph::Depth kDepth = 6;
+constexpr int kNewVerticesCount = 4;
+
+std::string write_to_file(const Graph& graph, const std::string& file_name) {
+  const auto file_path =
+      (std::filesystem::temp_directory_path() / file_name).string();
+  auto writer = uni_course_cpp::FileWriter(file_path);
+  uni_course_cpp::printing::json::write_graph(
+      graph, writer, uni_course_cpp::printing::json::ElementOrder::Id);
+  writer.close();
+
+  auto file = std::ifstream(file_path, std::ios::binary);
+  auto data = std::string(std::istreambuf_iterator<char>(file), {});
+  std::filesystem::remove(file_path);
+  return data;
+}
+
+Graph generate(GraphGenerator::Params params) {
+  return GraphGenerator(std::move(params)).generate();
+}
+
+Graph generate_by_task(const GraphGenerator::Params& params) {
+  auto task = GraphGenerator(GraphGenerator::Params(params))
+                  .make_task(uni_course_cpp::CancellationToken());
+  while (task.resume()) {
+  }
+  return task.take_graph();
+}
+
+void test_same_seed_gives_same_file() {
+  const auto params = GraphGenerator::Params(kDepth, kNewVerticesCount, kSeed);
+  const auto first_file = write_to_file(generate(params), "seed_first.json");
+  const auto second_file = write_to_file(generate(params), "seed_second.json");
+  check(first_file == second_file, "Same seed gave different files");
+}
+
+void test_same_seed_gives_same_file_by_task() {
+  const auto params = GraphGenerator::Params(kDepth, kNewVerticesCount, kSeed);
+  const auto first_file =
+      write_to_file(generate_by_task(params), "task_seed_first.json");
+  const auto second_file =
+      write_to_file(generate_by_task(params), "task_seed_second.json");
+  check(first_file == second_file, "Same seed gave different task files");
+}
+
+void test_task_gives_same_file_as_generate() {
+  const auto params = GraphGenerator::Params(kDepth, kNewVerticesCount, kSeed);
+  const auto file = write_to_file(generate(params), "generate_seed.json");
+  const auto task_file =
+      write_to_file(generate_by_task(params), "task_seed.json");
+  check(file == task_file, "Task gave a different file than generate()");
+}
+
+void test_different_seeds_give_different_files() {
+  const auto first_file = write_to_file(
+      generate(GraphGenerator::Params(kDepth, kNewVerticesCount, kSeed)),
+      "seed_first.json");
+  const auto second_file = write_to_file(
+      generate(GraphGenerator::Params(kDepth, kNewVerticesCount, kSeed + 1)),
+      "seed_second.json");
+  check(first_file != second_file, "Different seeds gave the same file");
+}
+}  // namespace
+
+int main() {
+  try {
+    test_same_seed_gives_same_file();
+    test_same_seed_gives_same_file_by_task();
+    test_task_gives_same_file_as_generate();
+    test_different_seeds_give_different_files();
+  } catch (const std::exception& exception) {
+    std::cerr << "graph_generator_test: " << exception.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "graph_generator_test: OK" << std::endl;
+  return 0;
+}
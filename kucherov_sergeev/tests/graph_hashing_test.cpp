@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../graph.hpp"
+#include "../graph_generator.hpp"
+#include "../graph_hashing.hpp"
+#include "graph_checks.hpp"
+
+using Graph = uni_course_cpp::Graph;
+using GraphGenerator = uni_course_cpp::GraphGenerator;
+using tests::check;
+
+namespace {
+constexpr GraphGenerator::Seed kSeed = 20240917;
+constexpr Graph::Depth kDepth = 6;
+constexpr int kNewVerticesCount = 4;
+
+Graph generate_graph(GraphGenerator::Seed seed) {
+  return GraphGenerator(GraphGenerator::Params(kDepth, kNewVerticesCount, seed))
+      .generate();
+}
+
+// The same graph with the vertices of every depth and the non-grey edges
+// added in the reverse id order, so most ids change
+Graph relabel(const Graph& graph) {
+  auto grey_parent_ids = std::unordered_map<Graph::VertexId, Graph::VertexId>();
+  auto other_edge_ids = std::vector<Graph::EdgeId>();
+  for (const auto& [edge_id, edge] : graph.get_edges()) {
+    if (edge.color() == Graph::Edge::Color::Grey) {
+      grey_parent_ids[edge.to_vertex_id()] = edge.from_vertex_id();
+    } else {
+      other_edge_ids.push_back(edge_id);
+    }
+  }
+
+  auto relabelled_graph = Graph();
+  auto new_ids = std::unordered_map<Graph::VertexId, Graph::VertexId>();
+  for (Graph::Depth depth = 0; depth <= graph.get_depth(); depth++) {
+    auto vertex_ids = graph.get_depth_vertex_ids(depth);
+    std::sort(vertex_ids.begin(), vertex_ids.end(), std::greater<>());
+    for (const auto vertex_id : vertex_ids) {
+      new_ids[vertex_id] = relabelled_graph.add_vertex();
+      const auto parent_id = grey_parent_ids.find(vertex_id);
+      if (parent_id != grey_parent_ids.end()) {
+        relabelled_graph.add_edge(new_ids.at(parent_id->second),
+                                  new_ids.at(vertex_id));
+      }
+    }
+  }
+
+  std::sort(other_edge_ids.begin(), other_edge_ids.end(), std::greater<>());
+  for (const auto edge_id : other_edge_ids) {
+    const auto& edge = graph.get_edges().at(edge_id);
+    relabelled_graph.add_edge(new_ids.at(edge.from_vertex_id()),
+                              new_ids.at(edge.to_vertex_id()));
+  }
+  return relabelled_graph;
+}
+
+// A root with two children and a grandchild under the first one, with a
+// green loop on the given vertex
+Graph make_graph_with_loop(int loop_vertex_index) {
+  auto graph = Graph();
+  const auto root_id = graph.add_vertex();
+  const auto first_child_id = graph.add_vertex();
+  const auto second_child_id = graph.add_vertex();
+  const auto grandchild_id = graph.add_vertex();
+  graph.add_edge(root_id, first_child_id);
+  graph.add_edge(root_id, second_child_id);
+  graph.add_edge(first_child_id, grandchild_id);
+
+  const auto loop_vertex_id = std::vector<Graph::VertexId>{
+      root_id, first_child_id, second_child_id,
+      grandchild_id}[loop_vertex_index];
+  graph.add_edge(loop_vertex_id, loop_vertex_id);
+  return graph;
+}
+
+bool is_isomorphic(const Graph& first, const Graph& second) {
+  const auto first_hashes = uni_course_cpp::get_structural_hashes(first);
+  const auto second_hashes = uni_course_cpp::get_structural_hashes(second);
+  return first_hashes.graph_hash == second_hashes.graph_hash &&
+         uni_course_cpp::get_canonical_form(first, first_hashes) ==
+             uni_course_cpp::get_canonical_form(second, second_hashes);
+}
+
+void test_shared_hashes() {
+  const auto graph = generate_graph(kSeed);
+  const auto hashes = uni_course_cpp::get_structural_hashes(graph);
+  check(hashes.graph_hash == uni_course_cpp::get_structural_hash(graph),
+        "Shared hashes give a different graph hash");
+  check(uni_course_cpp::get_canonical_form(graph, hashes) ==
+            uni_course_cpp::get_canonical_form(graph),
+        "Shared hashes give a different canonical form");
+}
+
+void test_isomorphic_graphs() {
+  for (const auto& graph :
+       {Graph(), make_graph_with_loop(1), generate_graph(kSeed)}) {
+    const auto relabelled_graph = relabel(graph);
+    tests::check_well_formed(relabelled_graph);
+    check(graph.get_vertices().size() < 3 ||
+              !tests::is_equal(graph, relabelled_graph),
+          "Relabelled graph has the same ids");
+    check(is_isomorphic(graph, relabelled_graph),
+          "Relabelled graph isn't found isomorphic");
+  }
+}
+
+void check_different(const Graph& first,
+                     const Graph& second,
+                     const std::string& graphs_name) {
+  check(uni_course_cpp::get_structural_hash(first) !=
+            uni_course_cpp::get_structural_hash(second),
+        graphs_name + " have the same hash");
+  check(uni_course_cpp::get_canonical_form(first) !=
+            uni_course_cpp::get_canonical_form(second),
+        graphs_name + " have the same canonical form");
+}
+
+void test_different_graphs() {
+  // Same sizes and depths, only the structure tells these graphs apart
+  for (int first_index = 0; first_index < 4; first_index++) {
+    for (int second_index = first_index + 1; second_index < 4;
+         second_index++) {
+      check_different(make_graph_with_loop(first_index),
+                      make_graph_with_loop(second_index),
+                      "Graphs with loops on vertices " +
+                          std::to_string(first_index) + " and " +
+                          std::to_string(second_index));
+    }
+  }
+  check_different(generate_graph(kSeed), generate_graph(kSeed + 1),
+                  "Graphs of different seeds");
+}
+}  // namespace
+
+int main() {
+  try {
+    test_shared_hashes();
+    test_isomorphic_graphs();
+    test_different_graphs();
+  } catch (const std::exception& exception) {
+    std::cerr << "graph_hashing_test: " << exception.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "graph_hashing_test: OK" << std::endl;
+  return 0;
+}
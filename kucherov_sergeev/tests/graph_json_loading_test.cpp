@@ -0,0 +1,134 @@
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../buffered_writer.hpp"
+#include "../graph.hpp"
+#include "../graph_generator.hpp"
+#include "../graph_json_loading.hpp"
+#include "../graph_json_printing.hpp"
+#include "graph_checks.hpp"
+
+using Graph = uni_course_cpp::Graph;
+using GraphGenerator = uni_course_cpp::GraphGenerator;
+using ElementOrder = uni_course_cpp::printing::json::ElementOrder;
+using Style = uni_course_cpp::printing::json::Style;
+using tests::check;
+
+namespace {
+constexpr GraphGenerator::Seed kSeed = 20240917;
+constexpr Graph::Depth kDepth = 6;
+constexpr int kNewVerticesCount = 4;
+
+// A root with a grey edge down and a green loop
+constexpr const char* kValidGraphJson =
+    R"({"depth":2,"vertices":[)"
+    R"({"id":0,"edge_ids":[0,1],"depth":1},)"
+    R"({"id":1,"edge_ids":[0],"depth":2}],"edges":[)"
+    R"({"id":0,"vertex_ids":[0,1],"color":"grey"},)"
+    R"({"id":1,"vertex_ids":[0,0],"color":"green"}]})";
+
+std::string replace(std::string string,
+                    const std::string& from,
+                    const std::string& to) {
+  const auto position = string.find(from);
+  check(position != std::string::npos, "No '" + from + "' to replace");
+  return string.replace(position, from.size(), to);
+}
+
+void test_round_trip() {
+  const auto graph =
+      GraphGenerator(GraphGenerator::Params(kDepth, kNewVerticesCount, kSeed))
+          .generate();
+  for (const auto& current_graph : {Graph(), graph}) {
+    for (const auto order : {ElementOrder::Storage, ElementOrder::Id}) {
+      for (const auto style : {Style::Pretty, Style::Compact}) {
+        const auto graph_json = uni_course_cpp::printing::json::print_graph(
+            current_graph, order, style);
+        check(tests::is_equal(
+                  uni_course_cpp::loading::json::parse_graph(graph_json),
+                  current_graph),
+              "Parsed graph differs from the printed one");
+      }
+    }
+  }
+
+  const auto file_path =
+      (std::filesystem::temp_directory_path() / "json_round_trip.json")
+          .string();
+  {
+    auto writer = uni_course_cpp::FileWriter(file_path);
+    uni_course_cpp::printing::json::write_graph(graph, writer);
+    writer.close();
+  }
+  const auto read_graph = uni_course_cpp::loading::json::read_graph(file_path);
+  std::filesystem::remove(file_path);
+  check(tests::is_equal(read_graph, graph),
+        "Read graph differs from the written one");
+}
+
+void test_malformed_input() {
+  const std::string valid_graph_json = kValidGraphJson;
+  tests::check_well_formed(
+      uni_course_cpp::loading::json::parse_graph(valid_graph_json));
+
+  using NamedGraphJson = std::pair<std::string, std::string>;
+  const auto malformed_graph_jsons = std::vector<NamedGraphJson>{
+      {"empty document", ""},
+      {"not an object", "[]"},
+      {"truncated document",
+       valid_graph_json.substr(0, valid_graph_json.size() / 2)},
+      {"trailing data", valid_graph_json + "}"},
+      {"unknown field", replace(valid_graph_json, "\"depth\":2", "\"x\":2")},
+      {"string id", replace(valid_graph_json, "\"id\":1,", "\"id\":\"1\",")},
+      {"unknown color", replace(valid_graph_json, "green", "pink")},
+      {"duplicate vertex id",
+       replace(valid_graph_json, "{\"id\":1,\"edge_ids\"",
+               "{\"id\":0,\"edge_ids\"")},
+      {"missing vertex",
+       replace(valid_graph_json, "\"vertex_ids\":[0,1]",
+               "\"vertex_ids\":[0,7]")},
+      {"inconsistent color", replace(valid_graph_json, "grey", "yellow")},
+      {"inconsistent edge ids",
+       replace(valid_graph_json, "\"edge_ids\":[0,1]", "\"edge_ids\":[0]")},
+      {"inconsistent vertex depth",
+       replace(valid_graph_json, "\"depth\":2}", "\"depth\":3}")},
+      {"inconsistent graph depth",
+       replace(valid_graph_json, "{\"depth\":2", "{\"depth\":4")}};
+
+  for (const auto& [name, graph_json] : malformed_graph_jsons) {
+    bool is_thrown = false;
+    try {
+      uni_course_cpp::loading::json::parse_graph(graph_json);
+    } catch (const std::runtime_error&) {
+      is_thrown = true;
+    }
+    check(is_thrown, "Graph with " + name + " is parsed");
+  }
+
+  bool is_thrown = false;
+  try {
+    uni_course_cpp::loading::json::read_graph(
+        (std::filesystem::temp_directory_path() / "missing_graph.json")
+            .string());
+  } catch (const std::runtime_error&) {
+    is_thrown = true;
+  }
+  check(is_thrown, "Missing file is read");
+}
+}  // namespace
+
+int main() {
+  try {
+    test_round_trip();
+    test_malformed_input();
+  } catch (const std::exception& exception) {
+    std::cerr << "graph_json_loading_test: " << exception.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "graph_json_loading_test: OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../buffered_writer.hpp"
+#include "../graph.hpp"
+#include "../graph_binary.hpp"
+#include "../graph_generator.hpp"
+#include "../graph_json_printing.hpp"
+#include "graph_checks.hpp"
+
+using Graph = uni_course_cpp::Graph;
+using GraphGenerator = uni_course_cpp::GraphGenerator;
+using GraphSlice = uni_course_cpp::printing::json::GraphSlice;
+using MappedGraph = uni_course_cpp::binary::MappedGraph;
+using Style = uni_course_cpp::printing::json::Style;
+using tests::check;
+
+namespace {
+constexpr GraphGenerator::Seed kSeed = 20240917;
+constexpr Graph::Depth kDepth = 6;
+constexpr int kNewVerticesCount = 4;
+
+std::string get_file_path(const std::string& file_name) {
+  return (std::filesystem::temp_directory_path() / file_name).string();
+}
+
+std::string read_file(const std::string& file_path) {
+  auto file = std::ifstream(file_path, std::ios::binary);
+  auto stream = std::ostringstream();
+  stream << file.rdbuf();
+  return stream.str();
+}
+
+std::vector<GraphSlice> make_slices() {
+  using Color = Graph::Edge::Color;
+  return {GraphSlice(),
+          {2, 4},
+          {1, 3, {Color::Grey, Color::Red}},
+          {3, 3, {Color::Green}},
+          {4, 100, {Color::Yellow, Color::Red}},
+          {0, 2, {}},
+          {5, 2}};
+}
+
+bool is_vertex_in_slice(const Graph& graph,
+                        const GraphSlice& slice,
+                        Graph::VertexId vertex_id) {
+  const auto depth = graph.get_vertex_depth(vertex_id);
+  return slice.min_depth <= depth && depth <= slice.max_depth;
+}
+
+bool is_edge_in_slice(const Graph& graph,
+                      const GraphSlice& slice,
+                      const Graph::Edge& edge) {
+  return std::find(slice.colors.begin(), slice.colors.end(), edge.color()) !=
+             slice.colors.end() &&
+         is_vertex_in_slice(graph, slice, edge.from_vertex_id()) &&
+         is_vertex_in_slice(graph, slice, edge.to_vertex_id());
+}
+
+// Vertices of the slice found by scanning the whole graph, by depth and id
+std::vector<Graph::VertexId> filter_vertex_ids(const Graph& graph,
+                                               const GraphSlice& slice) {
+  auto vertex_ids = std::vector<Graph::VertexId>();
+  for (const auto& [vertex_id, vertex] : graph.get_vertices()) {
+    if (is_vertex_in_slice(graph, slice, vertex_id)) {
+      vertex_ids.push_back(vertex_id);
+    }
+  }
+  std::sort(vertex_ids.begin(), vertex_ids.end(),
+            [&graph](Graph::VertexId first, Graph::VertexId second) {
+              return std::make_tuple(graph.get_vertex_depth(first), first) <
+                     std::make_tuple(graph.get_vertex_depth(second), second);
+            });
+  return vertex_ids;
+}
+
+// The compact slice document built from the whole graph instead of its
+// depth buckets and color index
+std::string print_filtered_graph(const Graph& graph, const GraphSlice& slice) {
+  const auto& edges = graph.get_edges();
+  auto edge_ids = std::vector<Graph::EdgeId>();
+  for (const auto& [edge_id, edge] : edges) {
+    if (is_edge_in_slice(graph, slice, edge)) {
+      edge_ids.push_back(edge_id);
+    }
+  }
+  std::sort(edge_ids.begin(), edge_ids.end(),
+            [&edges](Graph::EdgeId first, Graph::EdgeId second) {
+              return std::make_tuple(edges.at(first).color(), first) <
+                     std::make_tuple(edges.at(second).color(), second);
+            });
+
+  auto stream = std::ostringstream();
+  stream << "{\"depth\":"
+         << std::max(std::min(slice.max_depth, graph.get_depth()), 0)
+         << ",\"vertices\":[";
+  bool is_first_vertex = true;
+  for (const auto vertex_id : filter_vertex_ids(graph, slice)) {
+    stream << (is_first_vertex ? "" : ",") << "{\"id\":" << vertex_id
+           << ",\"edge_ids\":[";
+    bool is_first_edge = true;
+    for (const auto edge_id : graph.get_connected_edge_ids(vertex_id)) {
+      if (is_edge_in_slice(graph, slice, edges.at(edge_id))) {
+        stream << (is_first_edge ? "" : ",") << edge_id;
+        is_first_edge = false;
+      }
+    }
+    stream << "],\"depth\":" << graph.get_vertex_depth(vertex_id) << "}";
+    is_first_vertex = false;
+  }
+  stream << "],\"edges\":[";
+  for (std::size_t i = 0; i < edge_ids.size(); i++) {
+    stream << (i == 0 ? "" : ",")
+           << uni_course_cpp::printing::json::print_edge(
+                  edges.at(edge_ids[i]));
+  }
+  stream << "]}";
+  return stream.str();
+}
+
+void test_json_slice(const Graph& graph) {
+  const auto file_path = get_file_path("graph_slice.json");
+  for (const auto& slice : make_slices()) {
+    const auto slice_name = std::to_string(slice.min_depth) + ".." +
+                            std::to_string(slice.max_depth) + " of " +
+                            std::to_string(slice.colors.size()) + " colors";
+    const auto slice_json = uni_course_cpp::printing::json::print_graph_slice(
+        graph, slice, Style::Compact);
+    check(slice_json == print_filtered_graph(graph, slice),
+          "Slice " + slice_name + " differs from the filtered graph");
+
+    {
+      auto writer = uni_course_cpp::FileWriter(file_path);
+      uni_course_cpp::printing::json::write_graph_slice(graph, slice, writer,
+                                                        Style::Compact);
+      writer.close();
+    }
+    check(read_file(file_path) == slice_json,
+          "Written slice " + slice_name + " differs from the printed one");
+  }
+  std::filesystem::remove(file_path);
+}
+
+void test_mapped_depth_range(const Graph& graph) {
+  const auto file_path = get_file_path("graph_slice.ucgb");
+  uni_course_cpp::binary::write_graph(graph, file_path);
+  {
+    const auto mapped_graph = MappedGraph{file_path};
+    for (const auto& slice : make_slices()) {
+      const auto mapped_vertex_ids = mapped_graph.get_depth_range_vertex_ids(
+          slice.min_depth, slice.max_depth);
+      auto vertex_ids = std::vector<Graph::VertexId>(mapped_vertex_ids.begin(),
+                                                     mapped_vertex_ids.end());
+      check(std::is_sorted(vertex_ids.begin(), vertex_ids.end(),
+                           [&graph](Graph::VertexId first,
+                                    Graph::VertexId second) {
+                             return graph.get_vertex_depth(first) <
+                                    graph.get_vertex_depth(second);
+                           }),
+            "Mapped depth range isn't ordered by depth");
+      std::stable_sort(vertex_ids.begin(), vertex_ids.end(),
+                       [&graph](Graph::VertexId first, Graph::VertexId second) {
+                         return std::make_tuple(graph.get_vertex_depth(first),
+                                                first) <
+                                std::make_tuple(graph.get_vertex_depth(second),
+                                                second);
+                       });
+      check(vertex_ids == filter_vertex_ids(graph, slice),
+            "Mapped depth range " + std::to_string(slice.min_depth) + ".." +
+                std::to_string(slice.max_depth) +
+                " differs from the filtered graph");
+    }
+  }
+  std::filesystem::remove(file_path);
+}
+}  // namespace
+
+int main() {
+  try {
+    for (const auto& graph :
+         {Graph(), GraphGenerator(GraphGenerator::Params(
+                                      kDepth, kNewVerticesCount, kSeed))
+                       .generate()}) {
+      test_json_slice(graph);
+      test_mapped_depth_range(graph);
+    }
+  } catch (const std::exception& exception) {
+    std::cerr << "graph_slice_test: " << exception.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "graph_slice_test: OK" << std::endl;
+  return 0;
+}
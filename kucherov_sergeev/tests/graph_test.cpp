@@ -0,0 +1,119 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../graph.hpp"
+#include "graph_checks.hpp"
+
+using Graph = uni_course_cpp::Graph;
+using tests::check;
+using tests::is_equal;
+
+namespace {
+// A tree of the given depth with two children per vertex and an edge of
+// every other color
+Graph make_graph(Graph::Depth depth) {
+  auto graph = Graph();
+  auto parent_ids = std::vector<Graph::VertexId>{graph.add_vertex()};
+  for (Graph::Depth current_depth = 1; current_depth < depth;
+       current_depth++) {
+    auto child_ids = std::vector<Graph::VertexId>();
+    for (const auto parent_id : parent_ids) {
+      for (int i = 0; i < 2; i++) {
+        child_ids.push_back(graph.add_vertex());
+        graph.add_edge(parent_id, child_ids.back());
+      }
+    }
+    parent_ids = std::move(child_ids);
+  }
+
+  const auto& last_ids = graph.get_depth_vertex_ids(graph.get_depth());
+  graph.add_edge(last_ids[0], last_ids[0]);
+  graph.add_edge(graph.get_depth_vertex_ids(graph.get_depth() - 1)[0],
+                 last_ids[2]);
+  graph.add_edge(graph.get_depth_vertex_ids(graph.get_depth() - 2)[0],
+                 last_ids[last_ids.size() - 1]);
+  return graph;
+}
+
+// Adds a vertex with an edge, so the containers allocate and free through
+// their counters
+void grow(Graph& graph) {
+  graph.add_edge(0, graph.add_vertex());
+}
+
+void test_move_assignment() {
+  const auto expected_graph = make_graph(5);
+  auto source = make_graph(5);
+  const auto source_usage = source.get_memory_usage();
+
+  auto graph = make_graph(7);
+  graph = std::move(source);
+  source = Graph();
+  check(is_equal(graph, expected_graph), "Moved graph differs");
+  check(graph.get_memory_usage().total_bytes == source_usage.total_bytes,
+        "Moved graph lost its memory counters");
+
+  grow(graph);
+  check(graph.get_memory_usage().total_bytes > source_usage.total_bytes,
+        "Moved graph doesn't count new allocations");
+}
+
+void test_move_construction() {
+  const auto expected_graph = make_graph(5);
+  auto source = make_graph(5);
+  const auto source_usage = source.get_memory_usage();
+
+  auto graph = Graph(std::move(source));
+  check(is_equal(graph, expected_graph), "Moved graph differs");
+  check(graph.get_memory_usage().total_bytes == source_usage.total_bytes,
+        "Moved graph lost its memory counters");
+
+  // The moved-from graph is empty and counts to its own counters
+  check(is_equal(source, Graph()), "Moved-from graph isn't empty");
+  const auto empty_usage = source.get_memory_usage();
+  grow(source);
+  grow(source);
+  check(source.get_memory_usage().total_bytes > empty_usage.total_bytes,
+        "Moved-from graph doesn't count new allocations");
+  check(graph.get_memory_usage().total_bytes == source_usage.total_bytes,
+        "Moved-from graph counts to the moved graph");
+
+  source = Graph();
+  check(graph.get_memory_usage().total_bytes == source_usage.total_bytes,
+        "Moved-from graph freed through the moved graph counters");
+}
+
+void test_copy_assignment() {
+  const auto source = make_graph(5);
+
+  auto graph = make_graph(7);
+  graph = source;
+  check(is_equal(graph, source), "Copied graph differs");
+  check(graph.get_memory_usage().vertices_bytes ==
+            source.get_memory_usage().vertices_bytes,
+        "Copied graph doesn't count its vertices");
+
+  grow(graph);
+  check(!is_equal(graph, source), "Copied graph shares the source storage");
+
+  const auto& same_graph = graph;
+  graph = same_graph;
+  grow(graph);
+}
+}  // namespace
+
+int main() {
+  try {
+    test_move_assignment();
+    test_move_construction();
+    test_copy_assignment();
+  } catch (const std::exception& exception) {
+    std::cerr << "graph_test: " << exception.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "graph_test: OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef UNI_COURSE_CPP_USE_LIBNUMA
+#include <numa.h>
+#endif
+
+#include "thread_affinity.hpp"
+
+namespace uni_course_cpp {
+namespace thread_affinity {
+namespace {
+#ifdef __linux__
+inline constexpr const char* kNumaNodesPath = "/sys/devices/system/node/";
+
+std::vector<int> get_allowed_cpu_ids() {
+  std::vector<int> cpu_ids = {};
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+    for (int cpu_id = 0; cpu_id < CPU_SETSIZE; cpu_id++) {
+      if (CPU_ISSET(cpu_id, &cpu_set)) {
+        cpu_ids.push_back(cpu_id);
+      }
+    }
+  }
+
+  return cpu_ids;
+}
+
+// Parses the CPU and node lists of sysfs, like "0-3,8-11"
+std::vector<int> parse_id_list(const std::string& id_list) {
+  std::vector<int> ids = {};
+  std::stringstream id_list_stream(id_list);
+  std::string range;
+
+  while (std::getline(id_list_stream, range, ',')) {
+    const auto dash_position = range.find('-');
+    try {
+      const int first_id = std::stoi(range.substr(0, dash_position));
+      const int last_id = dash_position == std::string::npos
+                              ? first_id
+                              : std::stoi(range.substr(dash_position + 1));
+      for (int id = first_id; id <= last_id; id++) {
+        ids.push_back(id);
+      }
+    } catch (const std::exception&) {
+      continue;
+    }
+  }
+
+  return ids;
+}
+
+std::string read_first_line(const std::string& file_path) {
+  std::ifstream file(file_path);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+std::vector<CpuSet> read_numa_nodes(const std::vector<int>& allowed_cpu_ids) {
+  std::vector<CpuSet> numa_nodes = {};
+
+  // Node ids may have gaps, e.g. when a node is offline
+  const auto node_ids =
+      parse_id_list(read_first_line(std::string(kNumaNodesPath) + "online"));
+  for (const auto node : node_ids) {
+    const auto cpu_list = read_first_line(std::string(kNumaNodesPath) +
+                                          "node" + std::to_string(node) +
+                                          "/cpulist");
+
+    auto node_cpu_set = CpuSet{{}, node};
+    for (const auto cpu_id : parse_id_list(cpu_list)) {
+      if (std::binary_search(allowed_cpu_ids.begin(), allowed_cpu_ids.end(),
+                             cpu_id)) {
+        node_cpu_set.cpu_ids.push_back(cpu_id);
+      }
+    }
+
+    if (!node_cpu_set.cpu_ids.empty()) {
+      numa_nodes.push_back(std::move(node_cpu_set));
+    }
+  }
+
+  return numa_nodes;
+}
+#endif
+}  // namespace
+
+std::vector<CpuSet> get_numa_nodes() {
+#ifdef __linux__
+  const auto allowed_cpu_ids = get_allowed_cpu_ids();
+  auto numa_nodes = read_numa_nodes(allowed_cpu_ids);
+
+  if (numa_nodes.empty() && !allowed_cpu_ids.empty()) {
+    numa_nodes.push_back({allowed_cpu_ids, std::nullopt});
+  }
+
+  return numa_nodes;
+#else
+  return {};
+#endif
+}
+
+std::vector<CpuSet> make_worker_cpu_sets(int workers_count, Policy policy) {
+  const auto numa_nodes = get_numa_nodes();
+  if (policy == Policy::None || numa_nodes.empty()) {
+    return {};
+  }
+
+  std::vector<CpuSet> worker_cpu_sets = {};
+  worker_cpu_sets.reserve(workers_count);
+  std::vector<std::size_t> next_node_cpu_index(numa_nodes.size(), 0);
+
+  for (int worker_index = 0; worker_index < workers_count; worker_index++) {
+    const auto node_index = worker_index % numa_nodes.size();
+    const auto& numa_node = numa_nodes[node_index];
+
+    if (policy == Policy::NumaNode) {
+      worker_cpu_sets.push_back(numa_node);
+      continue;
+    }
+
+    auto& cpu_index = next_node_cpu_index[node_index];
+    worker_cpu_sets.push_back(
+        {{numa_node.cpu_ids[cpu_index % numa_node.cpu_ids.size()]},
+         numa_node.numa_node});
+    cpu_index++;
+  }
+
+  return worker_cpu_sets;
+}
+
+bool bind_current_thread(const CpuSet& cpu_set) {
+#ifdef __linux__
+  cpu_set_t native_cpu_set;
+  CPU_ZERO(&native_cpu_set);
+  for (const auto cpu_id : cpu_set.cpu_ids) {
+    if (cpu_id < 0 || cpu_id >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(cpu_id, &native_cpu_set);
+  }
+
+  if (pthread_setaffinity_np(pthread_self(), sizeof(native_cpu_set),
+                             &native_cpu_set) != 0) {
+    return false;
+  }
+
+#ifdef UNI_COURSE_CPP_USE_LIBNUMA
+  if (cpu_set.numa_node.has_value() && numa_available() != -1) {
+    numa_set_preferred(cpu_set.numa_node.value());
+  }
+#endif
+
+  return true;
+#else
+  return false;
+#endif
+}
+}  // namespace thread_affinity
+}  // namespace uni_course_cpp
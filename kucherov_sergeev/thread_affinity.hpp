@@ -0,0 +1,35 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+namespace uni_course_cpp {
+namespace thread_affinity {
+struct CpuSet {
+  std::vector<int> cpu_ids;
+  std::optional<int> numa_node;
+};
+
+enum class Policy {
+  // Threads migrate freely
+  None,
+  // Every worker is pinned to its own CPU
+  Cpu,
+  // Every worker is pinned to all CPUs of one NUMA node
+  NumaNode
+};
+
+// CPUs available to the process, grouped by NUMA node. Without NUMA
+// information all of them form a single node.
+std::vector<CpuSet> get_numa_nodes();
+
+// Workers are spread over the NUMA nodes round-robin.
+std::vector<CpuSet> make_worker_cpu_sets(int workers_count, Policy policy);
+
+// Threads started by the current thread afterwards inherit the affinity.
+// With libnuma the memory of the thread is also preferably allocated on its
+// NUMA node. Returns false if the binding isn't supported or fails, and
+// for CPU ids the platform can't represent, then the affinity is unchanged.
+bool bind_current_thread(const CpuSet& cpu_set);
+}  // namespace thread_affinity
+}  // namespace uni_course_cpp
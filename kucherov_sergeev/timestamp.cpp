@@ -0,0 +1,96 @@
+#include <charconv>
+#include <ctime>
+
+#include "timestamp.hpp"
+
+namespace uni_course_cpp {
+namespace {
+const auto kProcessStartTime = std::chrono::steady_clock::now();
+
+constexpr std::int64_t kSecondsInMinute = 60;
+
+// Floor division, so times before the epoch keep positive remainders
+std::int64_t floor_divide(std::int64_t dividend, std::int64_t divisor) {
+  const auto quotient = dividend / divisor;
+  return quotient * divisor > dividend ? quotient - 1 : quotient;
+}
+
+char* write_digits(char* position, std::int64_t value, int digits_count) {
+  for (int i = digits_count - 1; i >= 0; i--) {
+    position[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+  return position + digits_count;
+}
+}  // namespace
+
+TimestampFormatter::TimestampFormatter(TimestampClock clock,
+                                       TimestampResolution resolution)
+    : clock_(clock), resolution_(resolution) {}
+
+TimestampFormatter::Duration TimestampFormatter::now(TimestampClock clock) {
+  if (clock == TimestampClock::Steady) {
+    return std::chrono::duration_cast<Duration>(
+        std::chrono::steady_clock::now() - kProcessStartTime);
+  }
+  return std::chrono::duration_cast<Duration>(
+      std::chrono::system_clock::now().time_since_epoch());
+}
+
+std::string_view TimestampFormatter::format(Duration time) {
+  return clock_ == TimestampClock::Steady ? format_steady(time)
+                                          : format_system(time);
+}
+
+std::string_view TimestampFormatter::format_system(Duration time) {
+  const auto seconds =
+      floor_divide(time.count(), std::chrono::nanoseconds::period::den);
+  const auto minute = floor_divide(seconds, kSecondsInMinute);
+
+  if (minute != cached_minute_) {
+    const auto minute_time =
+        static_cast<std::time_t>(minute * kSecondsInMinute);
+    std::tm local_time;
+    localtime_r(&minute_time, &local_time);
+    std::strftime(buffer_.data(), buffer_.size(), "%Y.%m.%d %H:%M:",
+                  &local_time);
+    cached_minute_ = minute;
+  }
+
+  auto* position = buffer_.data() + kMinutePrefixLength;
+  position = write_digits(position, seconds - minute * kSecondsInMinute, 2);
+  position = write_fraction(position, time - std::chrono::seconds(seconds));
+  return std::string_view(buffer_.data(), position - buffer_.data());
+}
+
+std::string_view TimestampFormatter::format_steady(Duration time) {
+  const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(time);
+  auto* position =
+      std::to_chars(buffer_.data(), buffer_.data() + 20, seconds.count()).ptr;
+  position = write_fraction(position, time - seconds);
+  return std::string_view(buffer_.data(), position - buffer_.data());
+}
+
+char* TimestampFormatter::write_fraction(char* position,
+                                         Duration subsecond_time) const {
+  switch (resolution_) {
+    case TimestampResolution::Seconds:
+      return position;
+    case TimestampResolution::Milliseconds:
+      *position++ = '.';
+      return write_digits(
+          position,
+          std::chrono::duration_cast<std::chrono::milliseconds>(subsecond_time)
+              .count(),
+          3);
+    case TimestampResolution::Microseconds:
+      *position++ = '.';
+      return write_digits(
+          position,
+          std::chrono::duration_cast<std::chrono::microseconds>(subsecond_time)
+              .count(),
+          6);
+  }
+  return position;
+}
+}  // namespace uni_course_cpp
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace uni_course_cpp {
+enum class TimestampClock {
+  // Local wall-clock time, "2024.01.31 12:34:56"
+  System,
+  // Seconds since the process start, "12.345"
+  Steady
+};
+
+enum class TimestampResolution { Seconds, Milliseconds, Microseconds };
+
+// Formats timestamps without touching the tz lock on every call. The date
+// and time up to the minute are cached, so a timestamp within the cached
+// minute only rewrites its seconds and fraction digits. An instance is not
+// thread-safe, every thread formats with its own one.
+class TimestampFormatter {
+ public:
+  // Time since the epoch of the clock
+  using Duration = std::chrono::nanoseconds;
+
+  TimestampFormatter(TimestampClock clock, TimestampResolution resolution);
+
+  static Duration now(TimestampClock clock);
+
+  // The view is valid until the next call
+  std::string_view format(Duration time);
+
+ private:
+  static constexpr std::size_t kMinutePrefixLength =
+      sizeof("2024.01.31 12:34:") - 1;
+
+  std::string_view format_system(Duration time);
+  std::string_view format_steady(Duration time);
+  // Writes the fraction of the second, returns the end of the timestamp
+  char* write_fraction(char* position, Duration subsecond_time) const;
+
+  const TimestampClock clock_;
+  const TimestampResolution resolution_;
+  std::array<char, 64> buffer_ = {};
+  std::int64_t cached_minute_ = INT64_MIN;
+};
+}  // namespace uni_course_cpp
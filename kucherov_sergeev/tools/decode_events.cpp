@@ -0,0 +1,189 @@
+// Decodes the binary event log into the text log format, JSON or CSV.
+// Usage: decode_events <events file> [text|json|csv] [s|ms|us]
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "../event_log.hpp"
+#include "../graph_printing.hpp"
+#include "../log_level.hpp"
+#include "../timestamp.hpp"
+
+namespace {
+using Event = uni_course_cpp::event_log::Event;
+using EventType = uni_course_cpp::event_log::EventType;
+using GenerationStatus = uni_course_cpp::GenerationStatus;
+using TimestampFormatter = uni_course_cpp::TimestampFormatter;
+
+enum class Format { Text, Json, Csv };
+
+Format parse_format(const std::string& format) {
+  if (format == "text") {
+    return Format::Text;
+  }
+  if (format == "json") {
+    return Format::Json;
+  }
+  if (format == "csv") {
+    return Format::Csv;
+  }
+  throw std::runtime_error("Unknown format " + format);
+}
+
+uni_course_cpp::TimestampResolution parse_resolution(
+    const std::string& resolution) {
+  if (resolution == "s") {
+    return uni_course_cpp::TimestampResolution::Seconds;
+  }
+  if (resolution == "ms") {
+    return uni_course_cpp::TimestampResolution::Milliseconds;
+  }
+  if (resolution == "us") {
+    return uni_course_cpp::TimestampResolution::Microseconds;
+  }
+  throw std::runtime_error("Unknown resolution " + resolution);
+}
+
+std::string get_event_name(const Event& event) {
+  if (event.type == EventType::GenerationStarted) {
+    return "generation_started";
+  }
+  return event.status == GenerationStatus::Completed
+             ? "generation_finished"
+             : "generation_truncated";
+}
+
+std::string join_counts(const std::vector<int>& counts,
+                        const std::string& separator) {
+  std::string counts_string;
+  for (std::size_t i = 0; i < counts.size(); i++) {
+    if (i != 0) {
+      counts_string += separator;
+    }
+    counts_string += std::to_string(counts[i]);
+  }
+  return counts_string;
+}
+
+void print_text(const Event& event, std::string_view timestamp) {
+  const auto level = event.type == EventType::GenerationFinished &&
+                             event.status != GenerationStatus::Completed
+                         ? uni_course_cpp::LogLevel::Warning
+                         : uni_course_cpp::LogLevel::Info;
+  std::cout << timestamp << " " << uni_course_cpp::get_log_level_name(level)
+            << " Graph " << event.graph_index;
+  if (event.type == EventType::GenerationStarted) {
+    std::cout << ", Generation Started\n";
+    return;
+  }
+  if (event.status == GenerationStatus::Completed) {
+    std::cout << ", Generation Finished ";
+  } else {
+    std::cout << ", Generation Truncated ("
+              << uni_course_cpp::printing::print_generation_status(
+                     event.status)
+              << ") ";
+  }
+  std::cout << uni_course_cpp::printing::print_graph(event.summary) << "\n";
+}
+
+void print_json(const Event& event, std::string_view timestamp) {
+  std::cout << "{\"time\":\"" << timestamp
+            << "\",\"time_ns\":" << event.time.count() << ",\"event\":\""
+            << get_event_name(event) << "\",\"graph\":" << event.graph_index;
+  if (event.type == EventType::GenerationFinished) {
+    const auto& summary = event.summary;
+    std::cout << ",\"status\":\""
+              << uni_course_cpp::printing::print_generation_status(
+                     event.status)
+              << "\",\"duration_ns\":" << event.duration.count()
+              << ",\"depth\":" << summary.depth
+              << ",\"vertices\":{\"amount\":" << summary.vertices_count
+              << ",\"distribution\":["
+              << join_counts(summary.depth_vertices_counts, ",")
+              << "]},\"edges\":{\"amount\":" << summary.edges_count
+              << ",\"distribution\":{";
+    for (int color = 0; color < uni_course_cpp::Graph::Edge::kColorsCount;
+         color++) {
+      std::cout << (color == 0 ? "\"" : ",\"")
+                << uni_course_cpp::printing::print_edge_color(
+                       static_cast<uni_course_cpp::Graph::Edge::Color>(color))
+                << "\":" << summary.color_edges_counts[color];
+    }
+    std::cout << "}}";
+  }
+  std::cout << "}";
+}
+
+void print_csv_header() {
+  std::cout << "time,time_ns,event,graph,status,duration_ns,depth,vertices,"
+               "edges,grey,green,yellow,red,depth_vertices\n";
+}
+
+void print_csv(const Event& event, std::string_view timestamp) {
+  std::cout << timestamp << "," << event.time.count() << ","
+            << get_event_name(event) << "," << event.graph_index;
+  if (event.type == EventType::GenerationStarted) {
+    std::cout << ",,,,,,,,,,\n";
+    return;
+  }
+  const auto& summary = event.summary;
+  std::cout << ","
+            << uni_course_cpp::printing::print_generation_status(event.status)
+            << "," << event.duration.count() << "," << summary.depth << ","
+            << summary.vertices_count << "," << summary.edges_count;
+  for (const auto edges_count : summary.color_edges_counts) {
+    std::cout << "," << edges_count;
+  }
+  std::cout << "," << join_counts(summary.depth_vertices_counts, " ")
+            << "\n";
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 4) {
+    std::cerr << "Usage: " << argv[0]
+              << " <events file> [text|json|csv] [s|ms|us]\n";
+    return 1;
+  }
+
+  try {
+    const auto format = argc > 2 ? parse_format(argv[2]) : Format::Text;
+    const auto resolution =
+        argc > 3 ? parse_resolution(argv[3])
+                 : uni_course_cpp::TimestampResolution::Milliseconds;
+    const auto contents = uni_course_cpp::event_log::read_event_log(argv[1]);
+    auto timestamp_formatter = TimestampFormatter(contents.clock, resolution);
+
+    if (format == Format::Json) {
+      std::cout << "[";
+    } else if (format == Format::Csv) {
+      print_csv_header();
+    }
+    for (std::size_t i = 0; i < contents.events.size(); i++) {
+      const auto& event = contents.events[i];
+      const auto timestamp = timestamp_formatter.format(event.time);
+      switch (format) {
+        case Format::Text:
+          print_text(event, timestamp);
+          break;
+        case Format::Json:
+          std::cout << (i == 0 ? "\n  " : ",\n  ");
+          print_json(event, timestamp);
+          break;
+        case Format::Csv:
+          print_csv(event, timestamp);
+          break;
+      }
+    }
+    if (format == Format::Json) {
+      std::cout << "\n]\n";
+    }
+  } catch (const std::exception& exception) {
+    std::cerr << exception.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,261 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "buffered_writer.hpp"
+#include "tracing.hpp"
+
+namespace uni_course_cpp {
+namespace tracing {
+namespace {
+struct Event {
+  const char* name;
+  const char* category;
+  const char* argument_name;
+  std::int64_t argument_value;
+  std::int64_t start_time;
+  std::int64_t duration;
+};
+
+// Events of one thread, from first_event_index to the next track's one
+struct Track {
+  int thread_id = 0;
+  std::string thread_name;
+  std::size_t first_event_index = 0;
+};
+
+// Buffers of finished threads are reused, every owner starts its own track,
+// so the threads never share a tid or a name
+struct ThreadBuffer {
+  std::mutex mutex;
+  std::vector<Track> tracks;
+  std::vector<Event> events;
+};
+
+// Owns the buffers of all threads, finished or not
+class Registry {
+ public:
+  ThreadBuffer* acquire_buffer() {
+    const std::lock_guard lock(mutex_);
+    ThreadBuffer* buffer = nullptr;
+    if (!free_buffers_.empty()) {
+      buffer = free_buffers_.back();
+      free_buffers_.pop_back();
+    } else {
+      buffers_.push_back(std::make_unique<ThreadBuffer>());
+      buffer = buffers_.back().get();
+    }
+
+    const std::lock_guard buffer_lock(buffer->mutex);
+    auto& tracks = buffer->tracks;
+    // A previous owner without events leaves nothing to keep
+    if (!tracks.empty() &&
+        tracks.back().first_event_index == buffer->events.size()) {
+      tracks.pop_back();
+    }
+    tracks.push_back({++last_thread_id_, "", buffer->events.size()});
+    return buffer;
+  }
+
+  void release_buffer(ThreadBuffer* buffer) {
+    const std::lock_guard lock(mutex_);
+    free_buffers_.push_back(buffer);
+  }
+
+  template <typename Callback>
+  void for_each_buffer(const Callback& callback) {
+    const std::lock_guard lock(mutex_);
+    for (const auto& buffer : buffers_) {
+      const std::lock_guard buffer_lock(buffer->mutex);
+      callback(*buffer);
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+  std::vector<ThreadBuffer*> free_buffers_;
+  int last_thread_id_ = 0;
+};
+
+Registry& get_registry() {
+  // Never destroyed, threads may still release buffers at exit
+  static auto* const registry = new Registry();
+  return *registry;
+}
+
+class ThreadBufferHolder {
+ public:
+  ThreadBufferHolder() : buffer_(get_registry().acquire_buffer()) {}
+  ~ThreadBufferHolder() { get_registry().release_buffer(buffer_); }
+
+  ThreadBuffer& get() { return *buffer_; }
+
+ private:
+  ThreadBuffer* buffer_;
+};
+
+ThreadBuffer& get_thread_buffer() {
+  thread_local auto holder = ThreadBufferHolder();
+  return holder.get();
+}
+
+std::atomic<bool> is_tracing_enabled = false;
+const auto kTraceStartTime = std::chrono::steady_clock::now();
+
+std::int64_t get_time() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - kTraceStartTime)
+      .count();
+}
+
+// Chrome trace times are in microseconds
+void write_microseconds(BufferedWriter& writer, std::int64_t nanoseconds) {
+  char microseconds[32];
+  const int length =
+      std::snprintf(microseconds, sizeof(microseconds), "%lld.%03lld",
+                    static_cast<long long>(nanoseconds / 1000),
+                    static_cast<long long>(nanoseconds % 1000));
+  writer.write(std::string_view(microseconds, length));
+}
+
+void write_string(BufferedWriter& writer, std::string_view string) {
+  writer.write('"');
+  for (const char character : string) {
+    if (character == '"' || character == '\\') {
+      writer.write('\\');
+    }
+    writer.write(character);
+  }
+  writer.write('"');
+}
+}  // namespace
+
+void set_enabled(bool is_enabled) {
+  is_tracing_enabled.store(is_enabled, std::memory_order_relaxed);
+}
+
+bool is_enabled() {
+  return is_tracing_enabled.load(std::memory_order_relaxed);
+}
+
+void set_thread_name(const std::string& name) {
+  if (!is_enabled()) {
+    return;
+  }
+  auto& buffer = get_thread_buffer();
+  const std::lock_guard lock(buffer.mutex);
+  buffer.tracks.back().thread_name = name;
+}
+
+Span::Span(const char* name, const char* category)
+    : name_(name), category_(category) {
+  if (is_enabled()) {
+    start_time_ = get_time();
+  }
+}
+
+Span::Span(const char* name,
+           const char* category,
+           const char* argument_name,
+           std::int64_t argument_value)
+    : name_(name),
+      category_(category),
+      argument_name_(argument_name),
+      argument_value_(argument_value) {
+  if (is_enabled()) {
+    start_time_ = get_time();
+  }
+}
+
+Span::~Span() {
+  if (start_time_ < 0) {
+    return;
+  }
+
+  const auto event = Event{name_,           category_,
+                           argument_name_,  argument_value_,
+                           start_time_,     get_time() - start_time_};
+  auto& buffer = get_thread_buffer();
+  const std::lock_guard lock(buffer.mutex);
+  buffer.events.push_back(event);
+}
+
+void write_chrome_trace(const std::string& file_path) {
+  auto writer = FileWriter(file_path);
+  writer.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+  bool is_first_event = true;
+  const auto write_separator = [&writer, &is_first_event]() {
+    writer.write(is_first_event ? "\n" : ",\n");
+    is_first_event = false;
+  };
+
+  const auto write_track = [&writer, &write_separator](
+                               const Track& track,
+                               const Event* events_begin,
+                               const Event* events_end) {
+    if (!track.thread_name.empty()) {
+      write_separator();
+      writer.write(
+          "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+      writer.write(track.thread_id);
+      writer.write(",\"args\":{\"name\":");
+      write_string(writer, track.thread_name);
+      writer.write("}}");
+    }
+
+    for (const auto* event = events_begin; event != events_end; event++) {
+      write_separator();
+      writer.write("{\"name\":");
+      write_string(writer, event->name);
+      writer.write(",\"cat\":");
+      write_string(writer, event->category);
+      writer.write(",\"ph\":\"X\",\"ts\":");
+      write_microseconds(writer, event->start_time);
+      writer.write(",\"dur\":");
+      write_microseconds(writer, event->duration);
+      writer.write(",\"pid\":1,\"tid\":");
+      writer.write(track.thread_id);
+      if (event->argument_name != nullptr) {
+        writer.write(",\"args\":{");
+        write_string(writer, event->argument_name);
+        writer.write(':');
+        writer.write(static_cast<long long>(event->argument_value));
+        writer.write('}');
+      }
+      writer.write('}');
+    }
+  };
+
+  get_registry().for_each_buffer([&write_track](const ThreadBuffer& buffer) {
+    const auto* const events = buffer.events.data();
+    for (std::size_t i = 0; i < buffer.tracks.size(); i++) {
+      const auto events_end = i + 1 < buffer.tracks.size()
+                                  ? buffer.tracks[i + 1].first_event_index
+                                  : buffer.events.size();
+      write_track(buffer.tracks[i], events + buffer.tracks[i].first_event_index,
+                  events + events_end);
+    }
+  });
+
+  writer.write("\n]}\n");
+  writer.close();
+}
+
+void clear() {
+  // The last track may belong to a running thread, so only it is kept
+  get_registry().for_each_buffer([](ThreadBuffer& buffer) {
+    buffer.events.clear();
+    if (!buffer.tracks.empty()) {
+      buffer.tracks.erase(buffer.tracks.begin(), buffer.tracks.end() - 1);
+      buffer.tracks.back().first_event_index = 0;
+    }
+  });
+}
+}  // namespace tracing
+}  // namespace uni_course_cpp
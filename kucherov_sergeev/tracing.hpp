@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace uni_course_cpp {
+namespace tracing {
+// Scoped spans recorded to per-thread buffers and dumped as Chrome trace
+// JSON, which opens in chrome://tracing and Perfetto. While tracing is
+// disabled a span costs a single relaxed atomic load.
+void set_enabled(bool is_enabled);
+bool is_enabled();
+
+// Names the track of the calling thread, if tracing is enabled. Every
+// thread gets its own track, even when it reuses the buffer of a finished
+// one.
+void set_thread_name(const std::string& name);
+
+class Span {
+ public:
+  // The strings must outlive the dump, they are expected to be literals
+  explicit Span(const char* name, const char* category = "");
+  Span(const char* name,
+       const char* category,
+       const char* argument_name,
+       std::int64_t argument_value);
+  ~Span();
+
+  Span(const Span& other) = delete;
+  void operator=(const Span& other) = delete;
+
+ private:
+  const char* name_;
+  const char* category_;
+  const char* argument_name_ = nullptr;
+  std::int64_t argument_value_ = 0;
+  // Negative if the span isn't recorded
+  std::int64_t start_time_ = -1;
+};
+
+// Writes the spans recorded so far, the traced threads should be idle
+void write_chrome_trace(const std::string& file_path);
+void clear();
+}  // namespace tracing
+}  // namespace uni_course_cpp